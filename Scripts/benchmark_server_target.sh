@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+# Builds, cooks and stages the HelloMultiplayerServer and HelloMultiplayer targets for Linux,
+# then compares binary size, cold start time and resident memory of the two.
+#
+# The server is cooked with only the gameplay map. Server cooks already drop assets that
+# don't need to load on a server (particles, widgets, sounds, texture data), so together with
+# the UE_SERVER code paths this gives the server-only content set.
+#
+# The game target is measured as a headless listen server (-nullrhi -nosound) on the same map,
+# which is the closest thing it can run to a dedicated server.
+#
+# The table is also written to Saved/ServerBenchmark/results.txt, for pasting into the PR that changes the numbers.
+#
+# Usage: Scripts/benchmark_server_target.sh <path to UE 4.25 root> [configuration] [settle seconds]
+set -euo pipefail
+
+ENGINE_ROOT=${1:?usage: $0 <engine root> [configuration] [settle seconds]}
+CONFIG=${2:-Development}
+SETTLE=${3:-30}
+
+PROJECT_ROOT=$(cd "$(dirname "$0")/.." && pwd)
+UPROJECT="$PROJECT_ROOT/HelloMultiplayer.uproject"
+MAP=/Game/Level/GreyBox
+ARCHIVE="$PROJECT_ROOT/Saved/ServerBenchmark"
+UAT="$ENGINE_ROOT/Engine/Build/BatchFiles/RunUAT.sh"
+
+echo "== Building and cooking server target"
+"$UAT" BuildCookRun -project="$UPROJECT" -noP4 -utf8output \
+	-server -noclient -serverplatform=Linux -serverconfig="$CONFIG" \
+	-map="$MAP" -build -cook -stage -pak -archive -archivedirectory="$ARCHIVE/Server"
+
+echo "== Building and cooking game target"
+"$UAT" BuildCookRun -project="$UPROJECT" -noP4 -utf8output \
+	-platform=Linux -clientconfig="$CONFIG" \
+	-map="$MAP" -build -cook -stage -pak -archive -archivedirectory="$ARCHIVE/Game"
+
+binary_suffix() {
+	if [ "$CONFIG" = "Development" ]; then echo ""; else echo "-Linux-$CONFIG"; fi
+}
+
+SERVER_BIN="$ARCHIVE/Server/LinuxServer/HelloMultiplayer/Binaries/Linux/HelloMultiplayerServer$(binary_suffix)"
+GAME_BIN="$ARCHIVE/Game/LinuxNoEditor/HelloMultiplayer/Binaries/Linux/HelloMultiplayer$(binary_suffix)"
+
+# measure <name> <binary> <args...>
+# prints binary size, seconds until the engine reports it is initialized, and VmRSS after settling
+measure() {
+	local name=$1 binary=$2
+	shift 2
+	local log
+	log=$(mktemp)
+
+	local start end
+	start=$(date +%s.%N)
+	"$binary" "$@" -abslog="$log" -unattended >/dev/null 2>&1 &
+	local pid=$!
+
+	until grep -q "Game Engine Initialized" "$log" 2>/dev/null; do
+		if ! kill -0 "$pid" 2>/dev/null; then
+			echo "$name exited before initializing, see $log" >&2
+			return 1
+		fi
+		sleep 0.05
+	done
+	end=$(date +%s.%N)
+
+	sleep "$SETTLE"
+	local rss_kb
+	rss_kb=$(awk '/VmRSS/ { print $2 }' "/proc/$pid/status")
+	kill "$pid"
+	wait "$pid" 2>/dev/null || true
+
+	local size_bytes
+	size_bytes=$(stat -c %s "$binary")
+	printf "%-8s %12.1f %14.2f %12.1f\n" "$name" "$(echo "$size_bytes / 1048576" | bc -l)" \
+		"$(echo "$end - $start" | bc -l)" "$(echo "$rss_kb / 1024" | bc -l)"
+	rm -f "$log"
+}
+
+RESULTS="$ARCHIVE/results.txt"
+echo
+{
+	echo "HelloMultiplayer server benchmark, $CONFIG, $(date -u +%Y-%m-%d), settle ${SETTLE}s"
+	printf "%-8s %12s %14s %12s\n" "target" "binary MiB" "cold start s" "RSS MiB"
+	measure server "$SERVER_BIN" "$MAP" -log
+	measure game "$GAME_BIN" "$MAP?listen" -nullrhi -nosound -log
+} | tee "$RESULTS"
+echo "Results written to $RESULTS"
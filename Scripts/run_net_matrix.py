@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Runs scripted duels under a matrix of simulated network conditions.
+
+For every profile this starts a dedicated (or listen) server and N headless
+clients over loopback, all with the profile's packet simulation settings
+(-PktLag, -PktLagVariance, -PktLoss, applied to outgoing packets on each end).
+Each client runs with -DuelBot (see UDuelBotComponent), fights for the given
+duration, then logs a "DuelReport:" line and exits. The reports are merged per
+profile into hit-registration accuracy, movement corrections and percentiles of
+the press-to-confirmed-hit latency (projectile flight time excluded).
+
+Packet simulation is compiled out of Shipping builds, so use a Development
+(or DebugGame) editor or game binary.
+
+Example:
+    python3 Scripts/run_net_matrix.py --engine /opt/UE_4.25/Engine/Binaries/Linux/UE4Editor \
+        --clients 4 --duration 60 --profiles lan,wifi,mobile
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+PROJECT_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_UPROJECT = os.path.join(PROJECT_ROOT, "HelloMultiplayer.uproject")
+DEFAULT_MAP = "/Game/Level/GreyBox"
+
+# one-way lag and jitter in ms, loss in percent
+PROFILES = {
+    "lan":       {"PktLag": 0,   "PktLagVariance": 0,  "PktLoss": 0},
+    "broadband": {"PktLag": 20,  "PktLagVariance": 5,  "PktLoss": 0},
+    "wifi":      {"PktLag": 35,  "PktLagVariance": 15, "PktLoss": 1},
+    "mobile":    {"PktLag": 60,  "PktLagVariance": 30, "PktLoss": 3},
+    "bad":       {"PktLag": 100, "PktLagVariance": 50, "PktLoss": 8},
+}
+
+REPORT_RE = re.compile(
+    r"DuelReport: shots=(\d+) hits=(\d+) rolls=(\d+) corrections=(\d+) latencies_ms=([0-9.,]*)")
+
+
+def packet_sim_args(profile):
+    return ["-%s=%s" % (key, value) for key, value in profile.items()]
+
+
+def percentile(values, pct):
+    """Nearest-rank percentile, None for an empty list."""
+    if not values:
+        return None
+    ordered = sorted(values)
+    rank = max(0, min(len(ordered) - 1, int(math.ceil(pct / 100.0 * len(ordered))) - 1))
+    return ordered[rank]
+
+
+def parse_report(log_path):
+    if not os.path.exists(log_path):
+        return None
+    with open(log_path, errors="replace") as log:
+        for line in log:
+            match = REPORT_RE.search(line)
+            if match:
+                shots, hits, rolls, corrections, latencies = match.groups()
+                return {
+                    "shots": int(shots),
+                    "hits": int(hits),
+                    "rolls": int(rolls),
+                    "corrections": int(corrections),
+                    "latencies_ms": [float(v) for v in latencies.split(",") if v],
+                }
+    return None
+
+
+def run_profile(args, name, profile, log_dir):
+    sim = packet_sim_args(profile)
+    common = [args.uproject, "-unattended", "-nullrhi", "-nosound", "-nosplash"]
+
+    if args.listen:
+        server_cmd = [args.engine] + common + ["%s?listen" % args.map, "-game", "-port=%d" % args.port]
+    else:
+        server_cmd = [args.engine] + common + [args.map, "-server", "-port=%d" % args.port]
+    server_cmd += sim + ["-abslog=%s" % os.path.join(log_dir, "%s_server.log" % name)]
+
+    server = subprocess.Popen(server_cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    time.sleep(args.server_startup)
+
+    clients = []
+    client_logs = []
+    for index in range(args.clients):
+        log_path = os.path.join(log_dir, "%s_client%d.log" % (name, index))
+        client_logs.append(log_path)
+        client_cmd = [args.engine] + common + [
+            "127.0.0.1:%d" % args.port, "-game", "-DuelBot", "-DuelDuration=%d" % args.duration,
+            "-abslog=%s" % log_path] + sim
+        clients.append(subprocess.Popen(client_cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL))
+
+    deadline = time.time() + args.duration + args.timeout_slack
+    for client in clients:
+        try:
+            client.wait(timeout=max(1, deadline - time.time()))
+        except subprocess.TimeoutExpired:
+            client.kill()
+
+    server.terminate()
+    try:
+        server.wait(timeout=30)
+    except subprocess.TimeoutExpired:
+        server.kill()
+
+    reports = [parse_report(path) for path in client_logs]
+    missing = sum(1 for report in reports if report is None)
+    reports = [report for report in reports if report is not None]
+
+    shots = sum(r["shots"] for r in reports)
+    hits = sum(r["hits"] for r in reports)
+    latencies = [v for r in reports for v in r["latencies_ms"]]
+    return {
+        "profile": name,
+        "settings": profile,
+        "clients_reported": len(reports),
+        "clients_missing": missing,
+        "shots": shots,
+        "hits": hits,
+        "hit_accuracy": (float(hits) / shots) if shots else None,
+        "rolls": sum(r["rolls"] for r in reports),
+        "corrections": sum(r["corrections"] for r in reports),
+        "corrections_per_client_minute": (sum(r["corrections"] for r in reports) * 60.0 /
+                                          (len(reports) * args.duration)) if reports else None,
+        "latency_ms": {"p50": percentile(latencies, 50), "p90": percentile(latencies, 90),
+                       "p99": percentile(latencies, 99)},
+    }
+
+
+def format_value(value, fmt):
+    return "-" if value is None else fmt % value
+
+
+def print_table(results):
+    header = "%-10s %8s %6s %6s %9s %10s %8s %8s %8s" % (
+        "profile", "clients", "shots", "hits", "accuracy", "corr/min", "p50 ms", "p90 ms", "p99 ms")
+    print(header)
+    print("-" * len(header))
+    for r in results:
+        print("%-10s %8s %6d %6d %9s %10s %8s %8s %8s" % (
+            r["profile"], "%d/%d" % (r["clients_reported"], r["clients_reported"] + r["clients_missing"]),
+            r["shots"], r["hits"],
+            format_value(None if r["hit_accuracy"] is None else r["hit_accuracy"] * 100.0, "%.1f%%"),
+            format_value(r["corrections_per_client_minute"], "%.1f"),
+            format_value(r["latency_ms"]["p50"], "%.0f"), format_value(r["latency_ms"]["p90"], "%.0f"),
+            format_value(r["latency_ms"]["p99"], "%.0f")))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--engine", required=True, help="UE4Editor (or packaged game) executable")
+    parser.add_argument("--uproject", default=DEFAULT_UPROJECT)
+    parser.add_argument("--map", default=DEFAULT_MAP)
+    parser.add_argument("--clients", type=int, default=2)
+    parser.add_argument("--duration", type=int, default=60, help="seconds each duel runs")
+    parser.add_argument("--profiles", default=",".join(PROFILES), help="comma separated, from: " + ", ".join(PROFILES))
+    parser.add_argument("--listen", action="store_true", help="use a listen server instead of a dedicated one")
+    parser.add_argument("--port", type=int, default=7777)
+    parser.add_argument("--server-startup", type=float, default=20.0, help="seconds to wait before connecting clients")
+    parser.add_argument("--timeout-slack", type=float, default=120.0, help="extra seconds allowed for clients to exit")
+    parser.add_argument("--log-dir", default=None, help="where to keep logs, defaults to a temp directory")
+    parser.add_argument("--json", default=None, help="also write the results to this file")
+    args = parser.parse_args()
+
+    names = [name.strip() for name in args.profiles.split(",") if name.strip()]
+    unknown = [name for name in names if name not in PROFILES]
+    if unknown:
+        parser.error("unknown profile(s): %s" % ", ".join(unknown))
+
+    log_dir = args.log_dir or tempfile.mkdtemp(prefix="net_matrix_")
+    os.makedirs(log_dir, exist_ok=True)
+    print("Logs: %s" % log_dir)
+
+    results = []
+    for name in names:
+        print("Running profile '%s' with %d clients for %ds..." % (name, args.clients, args.duration))
+        results.append(run_profile(args, name, PROFILES[name], log_dir))
+
+    print_table(results)
+    if args.json:
+        with open(args.json, "w") as out:
+            json.dump(results, out, indent=2)
+
+    return 0 if all(r["clients_reported"] for r in results) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -10,5 +10,6 @@ public class HelloMultiplayerTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		ExtraModuleNames.Add("HelloMultiplayer");
+		ExtraModuleNames.Add("HelloMultiplayerUI");
 	}
 }
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AreaDamageSubsystem.h"
+#include "HelloMultiplayer.h"
+#include "HelloMultiplayerCharacter.h"
+#include "CollisionQueryParams.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/DamageType.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+DECLARE_CYCLE_STAT(TEXT("Area Damage Resolve"), STAT_AreaDamageResolve, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Area Damage Explosions"), STAT_AreaDamageExplosions, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Area Damage Hits"), STAT_AreaDamageHits, STATGROUP_HelloMultiplayer);
+
+void UAreaDamageSubsystem::QueueExplosion(const FAreaDamageRequest& Request)
+{
+	if (GetWorld()->GetNetMode() == NM_Client || Request.Radius <= 0.f)
+		return;
+
+	PendingExplosions.Add(Request);
+}
+
+bool UAreaDamageSubsystem::IsTickable() const
+{
+	return !IsTemplate() && PendingExplosions.Num() > 0;
+}
+
+TStatId UAreaDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAreaDamageSubsystem, STATGROUP_Tickables);
+}
+
+void UAreaDamageSubsystem::Tick(float DeltaTime)
+{
+	ResolveExplosions();
+}
+
+void UAreaDamageSubsystem::ResolveExplosions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AreaDamageResolve);
+	INC_DWORD_STAT_BY(STAT_AreaDamageExplosions, PendingExplosions.Num());
+
+	UWorld* World = GetWorld();
+
+	// one grid for every explosion of the frame; only built on frames that have explosions
+	Grid.Reset();
+	GridCharacters.Reset();
+	for (TActorIterator<AHelloMultiplayerCharacter> It(World); It; ++It)
+	{
+		if (It->IsPendingKill())
+			continue;
+
+		Grid.Add(GridCharacters.Add(*It), It->GetActorLocation());
+	}
+	Grid.Build();
+
+	// damage is applied after all queries, so explosions that kill don't change what later ones see
+	struct FPendingHit
+	{
+		int32 Request;
+		int32 Character;
+		float Damage;
+	};
+	TArray<FPendingHit, TInlineAllocator<64>> Hits;
+
+	for (int32 RequestIndex = 0; RequestIndex < PendingExplosions.Num(); ++RequestIndex)
+	{
+		const FAreaDamageRequest& Request = PendingExplosions[RequestIndex];
+		const float RadiusSq = Request.Radius * Request.Radius;
+
+		Grid.QuerySphere(Request.Origin, Request.Radius, [&](int32 CharacterIndex, const FVector& Location, float DistSq)
+		{
+			if (Request.bRequireLineOfSight)
+			{
+				FCollisionQueryParams Params(SCENE_QUERY_STAT(AreaDamageLineOfSight));
+				Params.AddIgnoredActor(Request.DamageCauser.Get(true));
+				Params.AddIgnoredActor(GridCharacters[CharacterIndex]);
+				if (World->LineTraceTestByChannel(Request.Origin, Location, ECC_Visibility, Params))
+					return;
+			}
+
+			const float Alpha = FMath::Pow(FMath::Sqrt(DistSq / RadiusSq), Request.DamageFalloff);
+			Hits.Add({ RequestIndex, CharacterIndex, FMath::Lerp(Request.BaseDamage, Request.MinimumDamage, Alpha) });
+		});
+	}
+
+	INC_DWORD_STAT_BY(STAT_AreaDamageHits, Hits.Num());
+
+	for (const FPendingHit& Hit : Hits)
+	{
+		const FAreaDamageRequest& Request = PendingExplosions[Hit.Request];
+		AHelloMultiplayerCharacter* Character = GridCharacters[Hit.Character];
+		if (Character->IsPendingKill())
+			continue;
+
+		FRadialDamageEvent DamageEvent;
+		DamageEvent.DamageTypeClass = Request.DamageType ? *Request.DamageType : UDamageType::StaticClass();
+		DamageEvent.Origin = Request.Origin;
+		DamageEvent.Params = FRadialDamageParams(Request.BaseDamage, Request.MinimumDamage, 0.f, Request.Radius, Request.DamageFalloff);
+
+		// the causer is usually a projectile destroyed on impact this frame, it's still a valid object until GC
+		Character->TakeDamage(Hit.Damage, DamageEvent, Request.InstigatorController.Get(), Request.DamageCauser.Get(true));
+	}
+
+	PendingExplosions.Reset();
+}
+
+namespace
+{
+	/** Times grid-backed resolution of Explosions queries against Characters points, and the brute force equivalent. */
+	void RunAreaDamageBench(int32 NumExplosions, int32 NumCharacters)
+	{
+		const float Radius = 400.f;
+		const float ArenaSize = 10000.f;
+		FRandomStream Random(NumExplosions * 7919 + NumCharacters);
+
+		TArray<FVector> Characters;
+		for (int32 i = 0; i < NumCharacters; ++i)
+		{
+			Characters.Add(FVector(Random.FRandRange(0.f, ArenaSize), Random.FRandRange(0.f, ArenaSize), Random.FRandRange(0.f, 300.f)));
+		}
+		TArray<FVector> Explosions;
+		for (int32 i = 0; i < NumExplosions; ++i)
+		{
+			Explosions.Add(FVector(Random.FRandRange(0.f, ArenaSize), Random.FRandRange(0.f, ArenaSize), Random.FRandRange(0.f, 300.f)));
+		}
+
+		FCharacterSpatialGrid Grid(UAreaDamageSubsystem::CellSize);
+		int32 GridHits = 0;
+		double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumCharacters; ++i)
+		{
+			Grid.Add(i, Characters[i]);
+		}
+		Grid.Build();
+		for (const FVector& Origin : Explosions)
+		{
+			Grid.QuerySphere(Origin, Radius, [&GridHits](int32, const FVector&, float) { ++GridHits; });
+		}
+		const double GridSeconds = FPlatformTime::Seconds() - Start;
+
+		int32 BruteHits = 0;
+		Start = FPlatformTime::Seconds();
+		for (const FVector& Origin : Explosions)
+		{
+			for (const FVector& Location : Characters)
+			{
+				BruteHits += FVector::DistSquared(Origin, Location) <= Radius * Radius ? 1 : 0;
+			}
+		}
+		const double BruteSeconds = FPlatformTime::Seconds() - Start;
+
+		UE_LOG(LogTemp, Display, TEXT("  %5d explosions x %5d characters: grid %9.1f us, brute force %9.1f us, %d hits%s"),
+			NumExplosions, NumCharacters, GridSeconds * 1e6, BruteSeconds * 1e6, GridHits,
+			GridHits == BruteHits ? TEXT("") : TEXT(" (MISMATCH)"));
+	}
+
+	/**
+	 * HelloMultiplayer.AreaDamageBench [Explosions Characters]
+	 * Without arguments, runs a matrix of explosion and character counts.
+	 */
+	void AreaDamageBench(const TArray<FString>& Args)
+	{
+		UE_LOG(LogTemp, Display, TEXT("AreaDamageBench (broadphase only, no line of sight traces)"));
+		if (Args.Num() >= 2)
+		{
+			RunAreaDamageBench(FCString::Atoi(*Args[0]), FCString::Atoi(*Args[1]));
+			return;
+		}
+
+		for (const int32 NumExplosions : { 16, 64, 256, 1024 })
+		{
+			for (const int32 NumCharacters : { 16, 64, 256, 1024 })
+			{
+				RunAreaDamageBench(NumExplosions, NumCharacters);
+			}
+		}
+	}
+
+	FAutoConsoleCommand AreaDamageBenchCommand(
+		TEXT("HelloMultiplayer.AreaDamageBench"),
+		TEXT("Benchmarks the area damage broadphase. Args: [Explosions Characters], runs a matrix without them."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&AreaDamageBench));
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Combat/CharacterSpatialGrid.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "AreaDamageSubsystem.generated.h"
+
+class AHelloMultiplayerCharacter;
+
+/** One explosion waiting to be resolved by UAreaDamageSubsystem. */
+struct FAreaDamageRequest
+{
+	FVector Origin = FVector::ZeroVector;
+	float Radius = 0.f;
+
+	/** Damage at the origin. */
+	float BaseDamage = 0.f;
+	/** Damage at the edge of the radius. */
+	float MinimumDamage = 0.f;
+	/** Shape of the falloff from BaseDamage to MinimumDamage, 1 is linear. */
+	float DamageFalloff = 1.f;
+
+	/** If true, characters behind world geometry (as seen from Origin) take no damage. */
+	bool bRequireLineOfSight = false;
+
+	TWeakObjectPtr<AActor> DamageCauser;
+	TWeakObjectPtr<AController> InstigatorController;
+	TSubclassOf<UDamageType> DamageType;
+};
+
+/**
+ * Server-side area damage. Explosions queued during a frame are resolved together at the end of it:
+ * character positions go into one uniform grid, every explosion queries it, and damage goes through
+ * the normal TakeDamage path as a radial damage event.
+ */
+UCLASS()
+class HELLOMULTIPLAYER_API UAreaDamageSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Queues an explosion for the end of this frame. Server only, ignored on clients. */
+	void QueueExplosion(const FAreaDamageRequest& Request);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject
+
+	/** Grid cell size in world units. About the typical explosion radius works best. */
+	static constexpr float CellSize = 500.f;
+
+private:
+	void ResolveExplosions();
+
+	TArray<FAreaDamageRequest> PendingExplosions;
+
+	/** Characters in the grid this frame, indexed by the grid entries. */
+	TArray<AHelloMultiplayerCharacter*> GridCharacters;
+	FCharacterSpatialGrid Grid = FCharacterSpatialGrid(CellSize);
+};
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CharacterSpatialGrid.h"
+
+FCharacterSpatialGrid::FCharacterSpatialGrid(float InCellSize)
+	: InvCellSize(1.f / FMath::Max(InCellSize, 1.f))
+{
+}
+
+void FCharacterSpatialGrid::Reset()
+{
+	Entries.Reset();
+	Cells.Reset();
+}
+
+void FCharacterSpatialGrid::Add(int32 Index, const FVector& Location)
+{
+	Entries.Add(FEntry{ Location, GetCell(Location), Index });
+}
+
+void FCharacterSpatialGrid::Build()
+{
+	Cells.Reset();
+
+	Entries.Sort([](const FEntry& A, const FEntry& B)
+	{
+		return A.Cell.X != B.Cell.X ? A.Cell.X < B.Cell.X : A.Cell.Y < B.Cell.Y;
+	});
+
+	// sorted, so each cell is one run of entries
+	for (int32 Start = 0; Start < Entries.Num();)
+	{
+		int32 End = Start + 1;
+		while (End < Entries.Num() && Entries[End].Cell == Entries[Start].Cell)
+		{
+			++End;
+		}
+
+		Cells.Add(Entries[Start].Cell, FCellRange{ Start, End - Start });
+		Start = End;
+	}
+}
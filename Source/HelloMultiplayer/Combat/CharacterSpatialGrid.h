@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform 2D grid (XY, any height) of points used as a broadphase for area queries.
+ * Rebuilt from scratch each time it is used: entries are sorted by cell so every cell is one contiguous
+ * run, and the allocations are kept between rebuilds.
+ */
+class HELLOMULTIPLAYER_API FCharacterSpatialGrid
+{
+public:
+	explicit FCharacterSpatialGrid(float InCellSize = 500.f);
+
+	/** Removes all points, keeping the memory. */
+	void Reset();
+
+	/** Adds a point with a caller-defined index. Call Build once all points are added. */
+	void Add(int32 Index, const FVector& Location);
+
+	/** Sorts the points into cells. Must be called after adding and before querying. */
+	void Build();
+
+	int32 Num() const { return Entries.Num(); }
+
+	/** Calls Visitor(Index, Location, DistanceSquared) for every point within Radius of Center. */
+	template<typename VisitorType>
+	void QuerySphere(const FVector& Center, float Radius, VisitorType&& Visitor) const
+	{
+		const float RadiusSq = Radius * Radius;
+		const FIntPoint Min = GetCell(Center - FVector(Radius));
+		const FIntPoint Max = GetCell(Center + FVector(Radius));
+
+		for (int32 X = Min.X; X <= Max.X; ++X)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+			{
+				const FCellRange* Range = Cells.Find(FIntPoint(X, Y));
+				if (!Range)
+					continue;
+
+				for (int32 i = Range->Start; i < Range->Start + Range->Num; ++i)
+				{
+					const FEntry& Entry = Entries[i];
+					const float DistSq = FVector::DistSquared(Center, Entry.Location);
+					if (DistSq <= RadiusSq)
+					{
+						Visitor(Entry.Index, Entry.Location, DistSq);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	struct FEntry
+	{
+		FVector Location;
+		FIntPoint Cell;
+		int32 Index;
+	};
+
+	struct FCellRange
+	{
+		int32 Start;
+		int32 Num;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+	}
+
+	float InvCellSize;
+	TArray<FEntry> Entries;
+	TMap<FIntPoint, FCellRange> Cells;
+};
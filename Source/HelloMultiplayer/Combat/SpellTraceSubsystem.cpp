@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpellTraceSubsystem.h"
+#include "HelloMultiplayer.h"
+#include "CollisionQueryParams.h"
+#include "Engine/World.h"
+#include "GameFramework/DamageType.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spell Traces In Flight"), STAT_SpellTracesInFlight, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spell Traces Issued"), STAT_SpellTracesIssued, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spell Traces Completed"), STAT_SpellTracesCompleted, STATGROUP_HelloMultiplayer);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Spell Trace Avg Latency (ms)"), STAT_SpellTraceLatency, STATGROUP_HelloMultiplayer);
+
+void USpellTraceSubsystem::StartTrace(const FSpellTraceRequest& Request)
+{
+	UWorld* World = GetWorld();
+	if (World->GetNetMode() == NM_Client)
+		return;
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(SpellTrace), false, Request.Caster.Get());
+
+	// by object type rather than the Visibility channel, which the Pawn capsule profile ignores: spells stop at world
+	// geometry and hit characters on their capsule, the same shape projectiles collide with
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+
+	FTraceHandle Handle;
+	if (Request.Mode == ESpellCastMode::Beam)
+	{
+		Handle = World->AsyncSweepByObjectType(EAsyncTraceType::Single, Request.Start, Request.End, FQuat::Identity, ObjectParams,
+			FCollisionShape::MakeSphere(Request.BeamRadius), Params);
+	}
+	else
+	{
+		Handle = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Request.Start, Request.End, ObjectParams, Params);
+	}
+
+	InFlightTraces.Add({ Handle, Request, FPlatformTime::Cycles64() });
+	INC_DWORD_STAT(STAT_SpellTracesIssued);
+	INC_DWORD_STAT(STAT_SpellTracesInFlight);
+}
+
+bool USpellTraceSubsystem::IsTickable() const
+{
+	return !IsTemplate() && InFlightTraces.Num() > 0;
+}
+
+TStatId USpellTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USpellTraceSubsystem, STATGROUP_Tickables);
+}
+
+void USpellTraceSubsystem::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	const uint64 Now = FPlatformTime::Cycles64();
+	double LatencyMsSum = 0.0;
+	int32 Completed = 0;
+
+	// collect everything the async batch finished, leave the rest for a later frame
+	for (int32 i = InFlightTraces.Num() - 1; i >= 0; --i)
+	{
+		const FInFlightTrace& Trace = InFlightTraces[i];
+
+		FTraceDatum Result;
+		if (World->QueryTraceData(Trace.Handle, Result))
+		{
+			LatencyMsSum += FPlatformTime::ToMilliseconds64(Now - Trace.IssueCycles);
+			++Completed;
+			ApplyResult(Trace.Request, Result);
+		}
+		else if (World->IsTraceHandleValid(Trace.Handle, false))
+		{
+			continue;
+		}
+
+		// completed, or the handle expired without a result
+		DEC_DWORD_STAT(STAT_SpellTracesInFlight);
+		InFlightTraces.RemoveAtSwap(i);
+	}
+
+	if (Completed > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_SpellTracesCompleted, Completed);
+		SET_FLOAT_STAT(STAT_SpellTraceLatency, LatencyMsSum / Completed);
+	}
+}
+
+void USpellTraceSubsystem::ApplyResult(const FSpellTraceRequest& Request, const FTraceDatum& Result)
+{
+	for (const FHitResult& Hit : Result.OutHits)
+	{
+		AActor* HitActor = Hit.GetActor();
+		if (Hit.bBlockingHit && HitActor)
+		{
+			const FVector Direction = (Request.End - Request.Start).GetSafeNormal();
+			UGameplayStatics::ApplyPointDamage(HitActor, Request.Damage, Direction, Hit, Request.InstigatorController.Get(),
+				Request.Caster.Get(), Request.DamageType ? *Request.DamageType : UDamageType::StaticClass());
+		}
+	}
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "SpellTraceSubsystem.generated.h"
+
+UENUM(BlueprintType)
+enum class ESpellCastMode : uint8
+{
+	/** Instant line trace, damages the first thing hit. */
+	Hitscan,
+	/** Instant sphere sweep of BeamRadius, damages the first thing hit. */
+	Beam
+};
+
+/** One spell trace to resolve. */
+struct FSpellTraceRequest
+{
+	ESpellCastMode Mode = ESpellCastMode::Hitscan;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	float BeamRadius = 0.f;
+	float Damage = 0.f;
+
+	TWeakObjectPtr<AActor> Caster;
+	TWeakObjectPtr<AController> InstigatorController;
+	TSubclassOf<UDamageType> DamageType;
+};
+
+/**
+ * Server-side hitscan spells without blocking scene queries. Traces are handed to the physics scene's async
+ * trace batch as the cast arrives; the engine runs everything requested in a frame together, and the results
+ * are collected and applied as damage on the next frame.
+ */
+UCLASS()
+class HELLOMULTIPLAYER_API USpellTraceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Starts a spell trace. Server only, ignored on clients. */
+	void StartTrace(const FSpellTraceRequest& Request);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject
+
+private:
+	struct FInFlightTrace
+	{
+		FTraceHandle Handle;
+		FSpellTraceRequest Request;
+		uint64 IssueCycles;
+	};
+
+	void ApplyResult(const FSpellTraceRequest& Request, const FTraceDatum& Result);
+
+	TArray<FInFlightTrace> InFlightTraces;
+};
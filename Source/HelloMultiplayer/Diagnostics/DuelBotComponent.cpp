@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DuelBotComponent.h"
+#include "HelloMultiplayerCharacter.h"
+#include "HelloMultiplayerProjectile.h"
+#include "Diagnostics/ShotTrace.h"
+#include "EngineUtils.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+UDuelBotComponent::UDuelBotComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UDuelBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FParse::Value(FCommandLine::Get(), TEXT("DuelDuration="), DuelDuration);
+
+	StartTime = FPlatformTime::Seconds();
+	NextFireTime = StartTime + FireInterval;
+	NextRollTime = StartTime + RollInterval;
+	NextStrafeTime = StartTime + StrafeInterval;
+
+	// strafe input is added from TickComponent, so it has to be in before the movement component consumes it
+	if (AHelloMultiplayerCharacter* Character = GetCharacter())
+	{
+		Character->GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, PrimaryComponentTick);
+
+		const AHelloMultiplayerProjectile* Projectile = Character->ProjectileClass.GetDefaultObject();
+		ProjectileSpeed = Projectile ? Projectile->ProjectileMovementComponent->InitialSpeed : 0.f;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Duel bot running for %.1f seconds"), DuelDuration);
+}
+
+AHelloMultiplayerCharacter* UDuelBotComponent::GetCharacter() const
+{
+	return Cast<AHelloMultiplayerCharacter>(GetOwner());
+}
+
+AHelloMultiplayerCharacter* UDuelBotComponent::FindTarget() const
+{
+	const AHelloMultiplayerCharacter* Self = GetCharacter();
+	AHelloMultiplayerCharacter* Best = nullptr;
+	float BestDistSq = TNumericLimits<float>::Max();
+
+	for (TActorIterator<AHelloMultiplayerCharacter> It(GetWorld()); It; ++It)
+	{
+		if (*It == Self || It->bIsDead)
+			continue;
+
+		const float DistSq = FVector::DistSquared(Self->GetActorLocation(), It->GetActorLocation());
+		if (DistSq < BestDistSq)
+		{
+			BestDistSq = DistSq;
+			Best = *It;
+		}
+	}
+	return Best;
+}
+
+void UDuelBotComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	AHelloMultiplayerCharacter* Character = GetCharacter();
+	if (!Character || !Character->Controller || bReported)
+		return;
+
+	const double Now = FPlatformTime::Seconds();
+
+	PollShots(Now);
+	PollHits(Now);
+	PollCorrections();
+	PollRolls();
+
+	if (Now - StartTime >= DuelDuration)
+	{
+		Report();
+		return;
+	}
+
+	if (AHelloMultiplayerCharacter* Target = FindTarget())
+	{
+		// aim so the projectile (spawned above the actor) travels straight at the target
+		const FVector Start = Character->GetActorLocation() + Character->GetActorUpVector() * 50.f;
+		Character->Controller->SetControlRotation((Target->GetActorLocation() - Start).Rotation());
+	}
+
+	if (Now >= NextStrafeTime)
+	{
+		StrafeSign = -StrafeSign;
+		NextStrafeTime = Now + StrafeInterval;
+	}
+	const FRotator YawRotation(0.f, Character->Controller->GetControlRotation().Yaw, 0.f);
+	Character->AddMovementInput(FRotationMatrix(YawRotation).GetUnitAxis(EAxis::Y), StrafeSign);
+
+	if (Now >= NextFireTime)
+	{
+		NextFireTime = Now + FireInterval;
+		PendingFirePressTime = Now;
+		Character->OnFirePressed();
+	}
+
+	if (Now >= NextRollTime)
+	{
+		NextRollTime = Now + RollInterval;
+		Character->OnRollPressed();
+	}
+}
+
+void UDuelBotComponent::PollShots(double Now)
+{
+	const int32 ShotId = GetCharacter()->LastFiredShotId;
+	if (ShotId == LastSeenShotId)
+		return;
+
+	LastSeenShotId = ShotId;
+	++ShotsFired;
+	FFiredShot& Shot = FiredShots.Add(ShotId);
+	Shot.PressTime = PendingFirePressTime >= 0.0 ? PendingFirePressTime : Now;
+	// same height offset the projectile spawns at
+	Shot.Origin = GetCharacter()->GetActorLocation() + GetCharacter()->GetActorUpVector() * 50.f;
+	PendingFirePressTime = -1.0;
+}
+
+void UDuelBotComponent::PollHits(double Now)
+{
+#if HM_WITH_SHOT_IDS
+	const AHelloMultiplayerCharacter* Self = GetCharacter();
+	for (TActorIterator<AHelloMultiplayerCharacter> It(GetWorld()); It; ++It)
+	{
+		if (*It == Self)
+			continue;
+
+		int32& SeenShotId = SeenDamageShotIds.FindOrAdd(*It, INDEX_NONE);
+		if (It->LastDamageShotId == SeenShotId)
+			continue;
+
+		SeenShotId = It->LastDamageShotId;
+
+		FFiredShot Shot;
+		if (FiredShots.RemoveAndCopyValue(SeenShotId, Shot))
+		{
+			++Hits;
+
+			// the projectile's flight is gameplay, not latency; estimated from the straight line to where the target is now
+			const double FlightTime = ProjectileSpeed > 0.f ? FVector::Dist(Shot.Origin, It->GetActorLocation()) / ProjectileSpeed : 0.0;
+			HitLatenciesMs.Add(FMath::Max(Now - Shot.PressTime - FlightTime, 0.0) * 1000.0);
+		}
+	}
+#endif
+}
+
+void UDuelBotComponent::PollCorrections()
+{
+	const FNetworkPredictionData_Client_Character* ClientData = GetCharacter()->GetCharacterMovement()->GetPredictionData_Client_Character();
+	if (ClientData && ClientData->LastCorrectionTime != LastCorrectionTime)
+	{
+		LastCorrectionTime = ClientData->LastCorrectionTime;
+		++Corrections;
+	}
+}
+
+void UDuelBotComponent::PollRolls()
+{
+	const bool bIsRolling = GetCharacter()->bIsRolling;
+	Rolls += (bIsRolling && !bWasRolling) ? 1 : 0;
+	bWasRolling = bIsRolling;
+}
+
+void UDuelBotComponent::Report()
+{
+	bReported = true;
+
+	FString Latencies;
+	for (const float LatencyMs : HitLatenciesMs)
+	{
+		Latencies += FString::Printf(TEXT("%s%.1f"), Latencies.IsEmpty() ? TEXT("") : TEXT(","), LatencyMs);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("DuelReport: shots=%d hits=%d rolls=%d corrections=%d latencies_ms=%s"),
+		ShotsFired, Hits, Rolls, Corrections, *Latencies);
+
+	FPlatformMisc::RequestExit(false);
+}
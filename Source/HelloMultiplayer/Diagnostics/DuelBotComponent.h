@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "DuelBotComponent.generated.h"
+
+class AHelloMultiplayerCharacter;
+
+/**
+ * Drives a locally controlled character through a scripted duel for the network-condition test matrix
+ * (Scripts/run_net_matrix.py). Added to the local character when the game is started with -DuelBot.
+ *
+ * The bot aims at the nearest other character, strafes, fires and rolls through the normal input path,
+ * and after DuelDuration seconds logs a "DuelReport:" line and exits. The report contains shots fired,
+ * confirmed hits, rolls, movement corrections received and the press-to-confirmed-hit latency of every hit,
+ * minus the projectile's estimated flight time.
+ */
+UCLASS( ClassGroup=(Custom) )
+class HELLOMULTIPLAYER_API UDuelBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	UDuelBotComponent();
+
+	/** Seconds to run the duel before reporting. Overridden by -DuelDuration=. */
+	UPROPERTY(EditAnywhere, Category="Duel")
+	float DuelDuration = 60.f;
+
+	/** Seconds between fire presses. */
+	UPROPERTY(EditAnywhere, Category="Duel")
+	float FireInterval = 0.3f;
+
+	/** Seconds between roll presses. */
+	UPROPERTY(EditAnywhere, Category="Duel")
+	float RollInterval = 2.5f;
+
+	/** Seconds before the strafe direction flips. */
+	UPROPERTY(EditAnywhere, Category="Duel")
+	float StrafeInterval = 1.f;
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+public:	
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	AHelloMultiplayerCharacter* GetCharacter() const;
+	AHelloMultiplayerCharacter* FindTarget() const;
+	void PollShots(double Now);
+	void PollHits(double Now);
+	void PollCorrections();
+	void PollRolls();
+	void Report();
+
+	double StartTime = 0.0;
+	double NextFireTime = 0.0;
+	double NextRollTime = 0.0;
+	double NextStrafeTime = 0.0;
+	float StrafeSign = 1.f;
+
+	/** Time of the fire press not yet matched to a fired shot, negative if none. */
+	double PendingFirePressTime = -1.0;
+	int32 LastSeenShotId = INDEX_NONE;
+
+	struct FFiredShot
+	{
+		double PressTime = 0.0;
+		FVector Origin = FVector::ZeroVector;
+	};
+
+	/** Every shot fired, by shot ID. Removed once the shot is confirmed as a hit. */
+	TMap<int32, FFiredShot> FiredShots;
+	float ProjectileSpeed = 0.f;
+	/** LastDamageShotId last seen on each other character. */
+	TMap<TWeakObjectPtr<AHelloMultiplayerCharacter>, int32> SeenDamageShotIds;
+
+	int32 ShotsFired = 0;
+	int32 Hits = 0;
+	int32 Rolls = 0;
+	int32 Corrections = 0;
+	float LastCorrectionTime = 0.f;
+	bool bWasRolling = false;
+	TArray<float> HitLatenciesMs;
+
+	bool bReported = false;
+};
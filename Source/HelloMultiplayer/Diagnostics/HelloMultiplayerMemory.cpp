@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HelloMultiplayerMemory.h"
+#include "HelloMultiplayerCharacter.h"
+#include "HelloMultiplayerProjectile.h"
+#include "Animation/AnimMontage.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+DECLARE_LLM_MEMORY_STAT(TEXT("HM_Characters"), STAT_HMCharactersLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("HM_Projectiles"), STAT_HMProjectilesLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("HelloMultiplayer"), STAT_HMSummaryLLM, STATGROUP_LLM);
+#endif
+
+void HelloMultiplayerMemory::RegisterLLMTags()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+	const FName Summary = GET_STATFNAME(STAT_HMSummaryLLM);
+	Tracker.RegisterProjectTag((int32)EHelloMultiplayerLLMTag::Characters, TEXT("HM_Characters"), GET_STATFNAME(STAT_HMCharactersLLM), Summary);
+	Tracker.RegisterProjectTag((int32)EHelloMultiplayerLLMTag::Projectiles, TEXT("HM_Projectiles"), GET_STATFNAME(STAT_HMProjectilesLLM), Summary);
+#endif
+}
+
+namespace
+{
+	/** Size of the object itself plus whatever it reports as exclusively owned (render data, buffers, ...). */
+	SIZE_T GetObjectBytes(const UObject* Object)
+	{
+		return Object->GetClass()->GetStructureSize() + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	struct FClassFootprint
+	{
+		int32 Instances = 0;
+		SIZE_T ActorBytes = 0;
+		SIZE_T ComponentBytes = 0;
+		/** Per-component breakdown of the first instance found. */
+		TArray<TPair<FString, SIZE_T>> SampleComponents;
+	};
+
+	void GatherFootprints(UWorld* World, UClass* BaseClass, TMap<UClass*, FClassFootprint>& OutFootprints)
+	{
+		for (TActorIterator<AActor> It(World, BaseClass); It; ++It)
+		{
+			AActor* Actor = *It;
+			FClassFootprint& Footprint = OutFootprints.FindOrAdd(Actor->GetClass());
+			const bool bIsSample = Footprint.Instances == 0;
+
+			++Footprint.Instances;
+			Footprint.ActorBytes += GetObjectBytes(Actor);
+
+			for (UActorComponent* Component : Actor->GetComponents())
+			{
+				const SIZE_T Bytes = GetObjectBytes(Component);
+				Footprint.ComponentBytes += Bytes;
+				if (bIsSample)
+				{
+					Footprint.SampleComponents.Emplace(Component->GetName(), Bytes);
+				}
+			}
+		}
+	}
+
+	void MemReport(const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+			return;
+
+		TMap<UClass*, FClassFootprint> Footprints;
+		GatherFootprints(World, AHelloMultiplayerCharacter::StaticClass(), Footprints);
+		GatherFootprints(World, AHelloMultiplayerProjectile::StaticClass(), Footprints);
+
+		UE_LOG(LogTemp, Display, TEXT("HelloMultiplayer memory report (%s)"), IsRunningDedicatedServer() ? TEXT("dedicated server") : TEXT("client"));
+		for (const TPair<UClass*, FClassFootprint>& Pair : Footprints)
+		{
+			const FClassFootprint& Footprint = Pair.Value;
+			const SIZE_T Total = Footprint.ActorBytes + Footprint.ComponentBytes;
+			UE_LOG(LogTemp, Display, TEXT("  %s: %d instances, %llu bytes total, %llu bytes/instance (actor %llu, components %llu)"),
+				*Pair.Key->GetName(), Footprint.Instances, (uint64)Total, (uint64)(Total / Footprint.Instances),
+				(uint64)(Footprint.ActorBytes / Footprint.Instances), (uint64)(Footprint.ComponentBytes / Footprint.Instances));
+
+			for (const TPair<FString, SIZE_T>& Component : Footprint.SampleComponents)
+			{
+				UE_LOG(LogTemp, Display, TEXT("    %s: %llu bytes"), *Component.Key, (uint64)Component.Value);
+			}
+		}
+
+		// montages are shared between all characters, so they're reported once rather than per instance
+		if (const AHelloMultiplayerCharacter* Character = Cast<AHelloMultiplayerCharacter>(AHelloMultiplayerCharacter::StaticClass()->GetDefaultObject()))
+		{
+			for (const UAnimMontage* Montage : { Character->RollMontage, Character->AttackMontage, Character->DeathMontage })
+			{
+				if (Montage)
+				{
+					UE_LOG(LogTemp, Display, TEXT("  shared %s: %llu bytes"), *Montage->GetName(), (uint64)Montage->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+				}
+			}
+		}
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs MemReportCommand(
+		TEXT("HelloMultiplayer.MemReport"),
+		TEXT("Logs bytes per instance and instance counts for HelloMultiplayer characters and projectiles."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&MemReport));
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+/** Low-Level Memory tracker tags for this module. Shown under the LLM stat groups when running with -LLM. */
+enum class EHelloMultiplayerLLMTag : LLM_TAG_TYPE
+{
+	Characters = (LLM_TAG_TYPE)ELLMTag::ProjectTagStart,
+	Projectiles,
+};
+
+/** Attributes allocations in the current scope to one of the EHelloMultiplayerLLMTag tags. */
+#define HM_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)EHelloMultiplayerLLMTag::Tag)
+
+#else
+
+#define HM_LLM_SCOPE(Tag)
+
+#endif
+
+namespace HelloMultiplayerMemory
+{
+	/** Registers the EHelloMultiplayerLLMTag names with the tracker. Called once on module startup. */
+	void RegisterLLMTags();
+}
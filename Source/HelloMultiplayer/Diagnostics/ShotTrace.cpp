@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShotTrace.h"
+
+#if UE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(ShotChannel);
+
+#endif
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Trace/Trace.h"
+
+/**
+ * Stages of the fire-to-damage pipeline, in the order a shot goes through them. Passed to TRACE_SHOT_STAGE by name.
+ *	ClientFire			StartFire on the shooting client
+ *	ServerReceive		Server_HandleFire_Implementation
+ *	ProjectileSpawn		projectile spawned on the server
+ *	ProjectileImpact	OnProjectileImpact on the server
+ *	TakeDamage			TakeDamage on the victim, server
+ *	SetHealth			SetCurrentHealth on the victim, server
+ *	HealthReplicated	OnRep_CurrentHealth on the victim, every client
+ */
+
+/**
+ * Whether shot IDs travel over the network (AHelloMultiplayerCharacter::LastDamageShotId). They only serve the shot
+ * trace and the duel bot, so Shipping doesn't send them.
+ */
+#define HM_WITH_SHOT_IDS (!UE_BUILD_SHIPPING)
+
+#if UE_TRACE_ENABLED
+
+/**
+ * Trace channel gating the shot stage bookmarks. Enable with -trace=cpu,bookmark,shot (or "Trace.Enable shot" at runtime).
+ * Each stage is a timing bookmark named "Shot <id> <stage>", so the stages of a shot show up on the Timing Insights
+ * timeline and can be found with the bookmark filter. The ID is assigned by the shooting client and carried to the
+ * victim, so the same ID appears in the client and server traces.
+ *
+ * Bookmark timestamps are per process and separate traces have unrelated clocks. For end-to-end latency, trace a PIE
+ * session with "Run Under One Process": server and clients then write one trace on one clock and the stage bookmarks
+ * of a shot can be subtracted directly. With separate processes, only stages recorded in the same trace can be compared.
+ */
+UE_TRACE_CHANNEL_EXTERN(ShotChannel, HELLOMULTIPLAYER_API);
+
+/** Records a pipeline stage for a shot. Only a channel check when the channel is off, nothing when trace is compiled out. */
+#define TRACE_SHOT_STAGE(ShotId, Stage) \
+	do \
+	{ \
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ShotChannel) && (ShotId) != INDEX_NONE) \
+		{ \
+			TRACE_BOOKMARK(TEXT("Shot %d ") TEXT(#Stage), (ShotId)); \
+		} \
+	} while (0)
+
+#else
+
+#define TRACE_SHOT_STAGE(ShotId, Stage)
+
+#endif
@@ -2,18 +2,39 @@
 
 
 #include "HelloMultiplayerGameModeBase.h"
+#include "HelloMultiplayerGameState.h"
+#include "Diagnostics/HelloMultiplayerMemory.h"
+#include "Scheduling/ServerTaskScheduler.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+
+AHelloMultiplayerGameModeBase::AHelloMultiplayerGameModeBase()
+{
+    GameStateClass = AHelloMultiplayerGameState::StaticClass();
+}
 
 void AHelloMultiplayerGameModeBase::BeginPlay()
 {
+    Super::BeginPlay();
+
     // get refs and win/lose condition
 
-    // call HandleGameStart() to init start countdown
+    // match setup doesn't need to share the first frame with everything else's BeginPlay
+    GetWorld()->GetSubsystem<UServerTaskScheduler>()->Schedule(this, [this]() { HandleGameStart(); }, EServerTaskPriority::High, 0.5f);
 }
 
 void AHelloMultiplayerGameModeBase::HandleGameStart()
 {
     //Init the start countdown
-    // Call Blueprint version of GameStart
+    GameStart();
+}
+
+APawn* AHelloMultiplayerGameModeBase::SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot)
+{
+    // the whole spawn, so registration, physics state and the anim instance are tagged along with the subobjects
+    HM_LLM_SCOPE(Characters);
+    return Super::SpawnDefaultPawnFor_Implementation(NewPlayer, StartSpot);
 }
 
 void AHelloMultiplayerGameModeBase::HandleGameOver()
@@ -21,9 +42,25 @@ void AHelloMultiplayerGameModeBase::HandleGameOver()
     
 }
 
-void AHelloMultiplayerGameModeBase::ActorDied(AActor* DeadActor)
+void AHelloMultiplayerGameModeBase::ActorDied(AActor* DeadActor, AController* Killer)
 {
-    
+    const APawn* DeadPawn = Cast<APawn>(DeadActor);
+    AHelloMultiplayerGameState* HMGameState = GetGameState<AHelloMultiplayerGameState>();
+    if (!DeadPawn || !HMGameState)
+    {
+        return;
+    }
+
+    HMGameState->AddKill(Killer ? Killer->GetPlayerState<APlayerState>() : nullptr, DeadPawn->GetPlayerState());
+}
+
+void AHelloMultiplayerGameModeBase::DamageDealt(AController* Dealer, float Damage)
+{
+    AHelloMultiplayerGameState* HMGameState = GetGameState<AHelloMultiplayerGameState>();
+    if (Dealer && HMGameState)
+    {
+        HMGameState->AddDamage(Dealer->GetPlayerState<APlayerState>(), Damage);
+    }
 }
 
 
@@ -10,6 +10,10 @@ UCLASS()
 class HELLOMULTIPLAYER_API AHelloMultiplayerGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
+
+public:
+
+	AHelloMultiplayerGameModeBase();
 	
 private:
 
@@ -18,11 +22,16 @@ private:
 	
 public:
 
-	void ActorDied(AActor* DeadActor);
+	/** Server: records a death on the scoreboard and kill feed. Killer may be null. */
+	void ActorDied(AActor* DeadActor, AController* Killer);
+
+	/** Server: credits damage to the dealer's scoreboard row. */
+	void DamageDealt(AController* Dealer, float Damage);
 	
 protected:
 
 	virtual void BeginPlay() override;
+	virtual APawn* SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot) override;
 	UFUNCTION(BlueprintImplementableEvent)
 	void GameStart();
 	UFUNCTION(BlueprintImplementableEvent)
@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HelloMultiplayerGameState.h"
+#include "HelloMultiplayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scoreboard Rows"), STAT_ScoreboardRows, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scoreboard Rows Dirtied"), STAT_ScoreboardRowsDirtied, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Kill Feed Kills"), STAT_KillFeedKills, STATGROUP_HelloMultiplayer);
+
+namespace
+{
+	FAutoConsoleCommandWithWorldAndArgs ScoreboardSimCommand(
+		TEXT("HelloMultiplayer.ScoreboardSim"),
+		TEXT("Server only. Fills the scoreboard with fake players and records random kills between them to measure ")
+		TEXT("scoreboard bandwidth with stat net. Usage: HelloMultiplayer.ScoreboardSim [Players=64] [KillsPerSecond=4] [Seconds=60]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			AHelloMultiplayerGameState* GameState = World ? World->GetGameState<AHelloMultiplayerGameState>() : nullptr;
+			if (!GameState || !GameState->HasAuthority())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("ScoreboardSim: needs an AHelloMultiplayerGameState on the server"));
+				return;
+			}
+
+			const int32 NumPlayers = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64;
+			const float KillsPerSecond = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 4.f;
+			const float Duration = Args.Num() > 2 ? FCString::Atof(*Args[2]) : 60.f;
+			GameState->StartScoreboardSimulation(NumPlayers, KillsPerSecond, Duration);
+		}));
+}
+
+void FScoreboardRow::PostReplicatedAdd(const FScoreboard& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnScoreboardChanged.Broadcast();
+	}
+}
+
+void FScoreboardRow::PostReplicatedChange(const FScoreboard& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnScoreboardChanged.Broadcast();
+	}
+}
+
+FScoreboardRow& FScoreboard::FindOrAddRow(int32 PlayerId)
+{
+	for (FScoreboardRow& Row : Rows)
+	{
+		if (Row.PlayerId == PlayerId)
+		{
+			return Row;
+		}
+	}
+
+	FScoreboardRow& Row = Rows.AddDefaulted_GetRef();
+	Row.PlayerId = PlayerId;
+	SET_DWORD_STAT(STAT_ScoreboardRows, Rows.Num());
+	return Row;
+}
+
+const FScoreboardRow* FScoreboard::FindRow(int32 PlayerId) const
+{
+	return Rows.FindByPredicate([PlayerId](const FScoreboardRow& Row) { return Row.PlayerId == PlayerId; });
+}
+
+AHelloMultiplayerGameState::AHelloMultiplayerGameState()
+{
+	KillFeed.SetNum(KillFeedCapacity);
+}
+
+void AHelloMultiplayerGameState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// set here rather than in the constructor, so the CDO and archetypes never hold an owner that instances copy
+	Scoreboard.Owner = this;
+}
+
+void AHelloMultiplayerGameState::AddKill(const APlayerState* Killer, const APlayerState* Victim)
+{
+	if (!HasAuthority() || !Victim)
+	{
+		return;
+	}
+
+	AddKillById(Killer ? Killer->GetPlayerId() : INDEX_NONE, Victim->GetPlayerId());
+}
+
+void AHelloMultiplayerGameState::AddKillById(int32 KillerId, int32 VictimId)
+{
+	FScoreboardRow& VictimRow = Scoreboard.FindOrAddRow(VictimId);
+	++VictimRow.Deaths;
+	Scoreboard.MarkItemDirty(VictimRow);
+	INC_DWORD_STAT(STAT_ScoreboardRowsDirtied);
+
+	// Suicides and environment kills only count as a death
+	if (KillerId != INDEX_NONE && KillerId != VictimId)
+	{
+		FScoreboardRow& KillerRow = Scoreboard.FindOrAddRow(KillerId);
+		++KillerRow.Kills;
+		Scoreboard.MarkItemDirty(KillerRow);
+		INC_DWORD_STAT(STAT_ScoreboardRowsDirtied);
+	}
+
+	const int32 Sequence = NextKillSequence++;
+	FKillFeedEntry& Entry = KillFeed[Sequence % KillFeedCapacity];
+	Entry.Sequence = Sequence;
+	Entry.KillerId = KillerId;
+	Entry.VictimId = VictimId;
+	Entry.ServerTime = GetServerWorldTimeSeconds();
+	INC_DWORD_STAT(STAT_KillFeedKills);
+
+	// Listen server host gets no OnRep
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		OnScoreboardChanged.Broadcast();
+		OnKillFeedChanged.Broadcast();
+	}
+}
+
+void AHelloMultiplayerGameState::AddDamage(const APlayerState* Dealer, float Damage)
+{
+	if (!HasAuthority() || !Dealer || Damage <= 0.f)
+	{
+		return;
+	}
+
+	FScoreboardRow& Row = Scoreboard.FindOrAddRow(Dealer->GetPlayerId());
+	Row.DamageDealt += Damage;
+	Scoreboard.MarkItemDirty(Row);
+	INC_DWORD_STAT(STAT_ScoreboardRowsDirtied);
+
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		OnScoreboardChanged.Broadcast();
+	}
+}
+
+TArray<FKillFeedEntry> AHelloMultiplayerGameState::GetKillFeed() const
+{
+	TArray<FKillFeedEntry> Entries;
+	Entries.Reserve(KillFeed.Num());
+	for (const FKillFeedEntry& Entry : KillFeed)
+	{
+		if (Entry.Sequence > 0)
+		{
+			Entries.Add(Entry);
+		}
+	}
+	Entries.Sort([](const FKillFeedEntry& A, const FKillFeedEntry& B) { return A.Sequence > B.Sequence; });
+	return Entries;
+}
+
+FString AHelloMultiplayerGameState::GetScoreboardName(int32 PlayerId) const
+{
+	// the scoreboard simulation's fake players have no player state
+	if (PlayerId < 0 && PlayerId != INDEX_NONE)
+	{
+		return FString::Printf(TEXT("SimPlayer%02d"), -PlayerId);
+	}
+
+	// player states already replicate the name, and renames with it
+	for (const APlayerState* PlayerState : PlayerArray)
+	{
+		if (PlayerState && PlayerState->GetPlayerId() == PlayerId)
+		{
+			return PlayerState->GetPlayerName();
+		}
+	}
+	return FString();
+}
+
+void AHelloMultiplayerGameState::OnRep_KillFeed()
+{
+	OnKillFeedChanged.Broadcast();
+}
+
+void AHelloMultiplayerGameState::StartScoreboardSimulation(int32 NumPlayers, float KillsPerSecond, float Duration)
+{
+	if (!HasAuthority() || NumPlayers < 2 || KillsPerSecond <= 0.f)
+	{
+		return;
+	}
+
+	// Fake players use negative ids so they never collide with real player states
+	SimulatedPlayers = NumPlayers;
+	for (int32 Index = 1; Index <= NumPlayers; ++Index)
+	{
+		FScoreboardRow& Row = Scoreboard.FindOrAddRow(-Index);
+		Scoreboard.MarkItemDirty(Row);
+	}
+
+	SimulationEndTime = GetWorld()->GetTimeSeconds() + Duration;
+	GetWorldTimerManager().SetTimer(SimulationTimer, this, &AHelloMultiplayerGameState::SimulateKill, 1.f / KillsPerSecond, true);
+	UE_LOG(LogTemp, Log, TEXT("ScoreboardSim: %d players, %.1f kills/s for %.0fs"), NumPlayers, KillsPerSecond, Duration);
+}
+
+void AHelloMultiplayerGameState::SimulateKill()
+{
+	if (GetWorld()->GetTimeSeconds() >= SimulationEndTime)
+	{
+		GetWorldTimerManager().ClearTimer(SimulationTimer);
+		UE_LOG(LogTemp, Log, TEXT("ScoreboardSim: done, %d kills recorded"), NextKillSequence - 1);
+		return;
+	}
+
+	const int32 Killer = FMath::RandRange(1, SimulatedPlayers);
+	const int32 Victim = 1 + (Killer + FMath::RandRange(0, SimulatedPlayers - 2)) % SimulatedPlayers;
+
+	FScoreboardRow& KillerRow = Scoreboard.FindOrAddRow(-Killer);
+	KillerRow.DamageDealt += 100.f;
+	AddKillById(-Killer, -Victim);
+}
+
+void AHelloMultiplayerGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AHelloMultiplayerGameState, Scoreboard);
+	DOREPLIFETIME(AHelloMultiplayerGameState, KillFeed);
+}
@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/GameStateBase.h"
+#include "HelloMultiplayerGameState.generated.h"
+
+class AHelloMultiplayerGameState;
+class APlayerState;
+
+/**
+ * Match stats of one player. Fast array items are sent whole on every change, so the row carries no name; look it
+ * up with AHelloMultiplayerGameState::GetScoreboardName.
+ */
+USTRUCT(BlueprintType)
+struct FScoreboardRow : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	int32 PlayerId = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	int32 Kills = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	int32 Deaths = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	float DamageDealt = 0.f;
+
+	void PostReplicatedAdd(const struct FScoreboard& InArraySerializer);
+	void PostReplicatedChange(const struct FScoreboard& InArraySerializer);
+};
+
+/** All scoreboard rows. Only rows marked dirty since the last net update are sent. */
+USTRUCT()
+struct FScoreboard : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FScoreboardRow> Rows;
+
+	UPROPERTY(NotReplicated)
+	AHelloMultiplayerGameState* Owner = nullptr;
+
+	/** Server: returns the row for a player, adding it if needed. Mark it dirty after changing it. */
+	FScoreboardRow& FindOrAddRow(int32 PlayerId);
+
+	const FScoreboardRow* FindRow(int32 PlayerId) const;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FScoreboardRow, FScoreboard>(Rows, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FScoreboard> : public TStructOpsTypeTraitsBase2<FScoreboard>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/** One kill in the kill feed. Names come from GetScoreboardName. */
+USTRUCT(BlueprintType)
+struct FKillFeedEntry
+{
+	GENERATED_BODY()
+
+	/** Increases with every kill; zero for an unused slot. */
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	int32 Sequence = 0;
+
+	/** INDEX_NONE if the victim died without a player to blame. */
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	int32 KillerId = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	int32 VictimId = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="Scoreboard")
+	float ServerTime = 0.f;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnScoreboardChanged);
+
+/**
+ * Game state holding the match scoreboard and kill feed, fed by ActorDied on either game mode.
+ * The scoreboard is a fast array, so a kill only sends the killer's and victim's rows. The kill feed is a fixed
+ * ring of the last KillFeedCapacity kills: a kill rewrites one slot, and late joiners receive the whole ring.
+ */
+UCLASS()
+class HELLOMULTIPLAYER_API AHelloMultiplayerGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	AHelloMultiplayerGameState();
+
+	virtual void PostInitializeComponents() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	static constexpr int32 KillFeedCapacity = 8;
+
+	/** Server: adds a kill to the scoreboard and kill feed. Killer may be null. */
+	void AddKill(const APlayerState* Killer, const APlayerState* Victim);
+
+	/** Server: adds damage dealt by a player to their row. */
+	void AddDamage(const APlayerState* Dealer, float Damage);
+
+	UFUNCTION(BlueprintPure, Category="Scoreboard")
+	const TArray<FScoreboardRow>& GetScoreboardRows() const { return Scoreboard.Rows; }
+
+	/** Kill feed entries, newest first. */
+	UFUNCTION(BlueprintPure, Category="Scoreboard")
+	TArray<FKillFeedEntry> GetKillFeed() const;
+
+	/** Name of a player on the scoreboard, taken from their player state. Empty once they have left the match. */
+	UFUNCTION(BlueprintPure, Category="Scoreboard")
+	FString GetScoreboardName(int32 PlayerId) const;
+
+	/** Called on clients when scoreboard rows arrive or change. */
+	UPROPERTY(BlueprintAssignable, Category="Scoreboard")
+	FOnScoreboardChanged OnScoreboardChanged;
+
+	/** Called on clients when the kill feed changes. */
+	UPROPERTY(BlueprintAssignable, Category="Scoreboard")
+	FOnScoreboardChanged OnKillFeedChanged;
+
+	/**
+	 * Server: fills the scoreboard with NumPlayers fake rows and records random kills between them at KillsPerSecond
+	 * for Duration seconds. Used to measure scoreboard bandwidth, see HelloMultiplayer.ScoreboardSim.
+	 */
+	void StartScoreboardSimulation(int32 NumPlayers, float KillsPerSecond, float Duration);
+
+protected:
+	UPROPERTY(Replicated)
+	FScoreboard Scoreboard;
+
+	/** Ring of KillFeedCapacity slots, written at Sequence % KillFeedCapacity. */
+	UPROPERTY(ReplicatedUsing=OnRep_KillFeed)
+	TArray<FKillFeedEntry> KillFeed;
+
+	UFUNCTION()
+	void OnRep_KillFeed();
+
+private:
+	void AddKillById(int32 KillerId, int32 VictimId);
+	void SimulateKill();
+
+	int32 NextKillSequence = 1;
+
+	int32 SimulatedPlayers = 0;
+	float SimulationEndTime = 0.f;
+	FTimerHandle SimulationTimer;
+};
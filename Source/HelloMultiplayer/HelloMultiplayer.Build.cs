@@ -8,6 +8,19 @@ public class HelloMultiplayer : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore" });
+
+		// Dedicated servers have no headset, so the VR code paths are compiled out along with the module.
+		// Camera and VFX paths are compiled out with UE_SERVER, which UBT already defines for server targets.
+		// Widgets live in the client-only HelloMultiplayerUI module, so this module doesn't depend on UMG.
+		if (Target.Type == TargetType.Server)
+		{
+			PublicDefinitions.Add("HM_WITH_VR=0");
+		}
+		else
+		{
+			PublicDependencyModuleNames.Add("HeadMountedDisplay");
+			PublicDefinitions.Add("HM_WITH_VR=1");
+		}
 	}
 }
@@ -1,7 +1,16 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "HelloMultiplayer.h"
+#include "Diagnostics/HelloMultiplayerMemory.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, HelloMultiplayer, "HelloMultiplayer" );
- 
\ No newline at end of file
+class FHelloMultiplayerModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		HelloMultiplayerMemory::RegisterLLMTags();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FHelloMultiplayerModule, HelloMultiplayer, "HelloMultiplayer" );
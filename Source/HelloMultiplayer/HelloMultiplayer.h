@@ -3,3 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/** Stat group for gameplay counters of this module. View with "stat HelloMultiplayer". */
+DECLARE_STATS_GROUP(TEXT("HelloMultiplayer"), STATGROUP_HelloMultiplayer, STATCAT_Advanced);
@@ -1,22 +1,42 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "HelloMultiplayerCharacter.h"
+#include "HelloMultiplayer.h"
 #include "HelloMultiplayerProjectile.h"
-#include "HealthBar.h"
+#include "Movement/HelloMultiplayerMovementComponent.h"
+#include "Diagnostics/HelloMultiplayerMemory.h"
+#include "Diagnostics/DuelBotComponent.h"
+#include "Diagnostics/ShotTrace.h"
+#include "HelloMultiplayerGameMode.h"
+#include "GameModes/HelloMultiplayerGameModeBase.h"
+#include "Scheduling/ServerTaskScheduler.h"
+#if HM_WITH_VR
 #include "HeadMountedDisplayFunctionLibrary.h"
+#endif
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
-#include "Components/WidgetComponent.h"
+#include "Animation/AnimInstance.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameSession.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "UObject/ConstructorHelpers.h"
 
 //networking includes
 #include "Net/UnrealNetwork.h"
 #include "Engine/Engine.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spell Casts Rejected"), STAT_SpellCastsRejected, STATGROUP_HelloMultiplayer);
+
 #define NET_LOG(msg) GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, msg)
 #define NET_LOG_C(msg, color) GEngine->AddOnScreenDebugMessage(-1, 5.f, color, msg)
 #define NET_LOG_LOCAL(msg) if (IsLocallyControlled()) NET_LOG_C(msg, FColor::Green)
@@ -25,7 +45,8 @@
 //////////////////////////////////////////////////////////////////////////
 // AHelloMultiplayerCharacter
 
-AHelloMultiplayerCharacter::AHelloMultiplayerCharacter()
+AHelloMultiplayerCharacter::AHelloMultiplayerCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UHelloMultiplayerMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -45,6 +66,10 @@ AHelloMultiplayerCharacter::AHelloMultiplayerCharacter()
 	GetCharacterMovement()->JumpZVelocity = 600.f;
 	GetCharacterMovement()->AirControl = 0.2f;
 
+#if !UE_SERVER
+	// Camera components are never used on a dedicated server, so server-only builds don't create them.
+	// GetCameraBoom() and GetFollowCamera() return null there.
+
 	// Create a camera boom (pulls in towards the player if there is a collision)
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
@@ -55,10 +80,13 @@ AHelloMultiplayerCharacter::AHelloMultiplayerCharacter()
 	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
+#endif
 
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named MyCharacter (to avoid direct content references in C++)
 
+	Stats = CreateDefaultSubobject<UStat>(TEXT("Stats"));
+
 	//init health
 	CurrentHealth = MaxHealth;
 	// HealthBar = CreateDefaultSubobject<UHealthBar>("HealthBar");
@@ -98,28 +126,73 @@ void AHelloMultiplayerCharacter::SetupPlayerInputComponent(class UInputComponent
 	PlayerInputComponent->BindTouch(IE_Pressed, this, &AHelloMultiplayerCharacter::TouchStarted);
 	PlayerInputComponent->BindTouch(IE_Released, this, &AHelloMultiplayerCharacter::TouchStopped);
 
+#if HM_WITH_VR
 	// VR headset functionality
 	PlayerInputComponent->BindAction("ResetVR", IE_Pressed, this, &AHelloMultiplayerCharacter::OnResetVR);
+#endif
 	
-	// Handle firing projectiles
-	PlayerInputComponent->BindAction("Fire", IE_Pressed, this, &AHelloMultiplayerCharacter::StartFire);
+	// Handle firing projectiles (buffered, see SampleBufferedActions)
+	PlayerInputComponent->BindAction("Fire", IE_Pressed, this, &AHelloMultiplayerCharacter::OnFirePressed);
+
+	// Handle spell casting
+	PlayerInputComponent->BindAction("CastSpell", IE_Pressed, this, &AHelloMultiplayerCharacter::StartCast);
 
-	// Handle dodge input
-	PlayerInputComponent->BindAction("Roll", IE_Pressed, this, &AHelloMultiplayerCharacter::Client_StartRoll);
+	// Handle dodge input (buffered, see SampleBufferedActions)
+	PlayerInputComponent->BindAction("Roll", IE_Pressed, this, &AHelloMultiplayerCharacter::OnRollPressed);
 }
 
 
-void AHelloMultiplayerCharacter::BeginPlay()
+void AHelloMultiplayerCharacter::PostInitializeComponents()
 {
-	Super::BeginPlay();
+	Super::PostInitializeComponents();
 
-	CurrentHealth = MaxHealth;
-	CurrentMana = MaxMana;
+	// base values come from the tunables, modifiers are applied on top. Set before BeginPlay so GetMaxHealth and
+	// GetMaxMana are valid from the moment the character is spawned.
+	Stats->SetBaseValue(EStatAttribute::MaxHealth, MaxHealth);
+	Stats->SetBaseValue(EStatAttribute::MaxMana, MaxMana);
+	Stats->SetBaseValue(EStatAttribute::FireRate, FireRate);
+	Stats->SetBaseValue(EStatAttribute::RollCooldown, RollCooldown);
+
+	// clients leave health and mana alone: for a net-spawned actor the initial replicated values are applied
+	// after this, and the OnRep_ handlers pick them up
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		CurrentHealth = GetMaxHealth();
+		CurrentMana = GetMaxMana();
+		// bound after the base values are seeded so the defaults above don't go through the clamp
+		Stats->OnAttributeChanged.AddUObject(this, &AHelloMultiplayerCharacter::OnStatChanged);
+	}
+}
+
+void AHelloMultiplayerCharacter::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+
+#if !UE_BUILD_SHIPPING
+	if (FParse::Param(FCommandLine::Get(), TEXT("DuelBot")) && !FindComponentByClass<UDuelBotComponent>())
+	{
+		UDuelBotComponent* DuelBot = NewObject<UDuelBotComponent>(this, TEXT("DuelBot"));
+		DuelBot->RegisterComponent();
+	}
+#endif
+}
+
+void AHelloMultiplayerCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// buffered presses are checked every frame, the buffer window itself is in seconds
+	if (IsLocallyControlled())
+	{
+		SampleBufferedActions();
+	}
 }
 
 void AHelloMultiplayerCharacter::OnResetVR()
 {
+#if HM_WITH_VR
 	UHeadMountedDisplayFunctionLibrary::ResetOrientationAndPosition();
+#endif
 }
 
 void AHelloMultiplayerCharacter::TouchStarted(ETouchIndex::Type FingerIndex, FVector Location)
@@ -148,13 +221,8 @@ void AHelloMultiplayerCharacter::MoveForward(float Value)
 {
 	if ((Controller != nullptr) && (Value != 0.0f))
 	{
-		// find out which way is forward
-		const FRotator Rotation = Controller->GetControlRotation();
-		const FRotator YawRotation(0, Rotation.Yaw, 0);
-
-		// get forward vector
-		const FVector Direction = FRotationMatrix(YawRotation).GetUnitAxis(EAxis::X);
-		AddMovementInput(Direction, Value);
+		UpdateInputYawBasis();
+		AddMovementInput(InputForward, Value);
 	}
 }
 
@@ -162,41 +230,159 @@ void AHelloMultiplayerCharacter::MoveRight(float Value)
 {
 	if ( (Controller != nullptr) && (Value != 0.0f) )
 	{
-		// find out which way is right
-		const FRotator Rotation = Controller->GetControlRotation();
-		const FRotator YawRotation(0, Rotation.Yaw, 0);
-	
-		// get right vector 
-		const FVector Direction = FRotationMatrix(YawRotation).GetUnitAxis(EAxis::Y);
-		// add movement in that direction
-		AddMovementInput(Direction, Value);
+		UpdateInputYawBasis();
+		AddMovementInput(InputRight, Value);
+	}
+}
+
+void AHelloMultiplayerCharacter::UpdateInputYawBasis()
+{
+	if (InputBasisFrame == GFrameCounter)
+		return;
+
+	// find out which way is forward and right, once per frame for both axes
+	const FRotator Rotation = Controller->GetControlRotation();
+	const FRotator YawRotation(0, Rotation.Yaw, 0);
+	const FRotationMatrix YawBasis(YawRotation);
+
+	InputForward = YawBasis.GetUnitAxis(EAxis::X);
+	InputRight = YawBasis.GetUnitAxis(EAxis::Y);
+	InputBasisFrame = GFrameCounter;
+}
+
+void AHelloMultiplayerCharacter::OnFirePressed()
+{
+	BufferedFirePressTime = GetWorld()->GetTimeSeconds();
+	SampleBufferedActions();
+}
+
+void AHelloMultiplayerCharacter::OnRollPressed()
+{
+	BufferedRollPressTime = GetWorld()->GetTimeSeconds();
+	SampleBufferedActions();
+}
+
+void AHelloMultiplayerCharacter::SampleBufferedActions()
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	if (BufferedFirePressTime >= 0.f)
+	{
+		if (Now - BufferedFirePressTime > InputBufferWindow)
+		{
+			BufferedFirePressTime = -1.f;
+		}
+		else if (!bIsCasting1H)
+		{
+			BufferedFirePressTime = -1.f;
+			StartFire();
+		}
+	}
+
+	if (BufferedRollPressTime >= 0.f)
+	{
+		if (Now - BufferedRollPressTime > InputBufferWindow)
+		{
+			BufferedRollPressTime = -1.f;
+		}
+		else if (CanRoll())
+		{
+			BufferedRollPressTime = -1.f;
+			Client_StartRoll();
+		}
 	}
 }
 
+float AHelloMultiplayerCharacter::GetServerWorldTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+float AHelloMultiplayerCharacter::GetOneWayLatency(const APlayerState* PlayerState)
+{
+	if (!PlayerState)
+		return 0.f;
+
+	// ExactPing is only measured on the server, clients get the replicated Ping which is in ms / 4
+	const float pingMs = PlayerState->ExactPing > 0.f ? PlayerState->ExactPing : PlayerState->GetPing() * 4.f;
+	return pingMs * 0.5f / 1000.f;
+}
+
+float AHelloMultiplayerCharacter::GetInputLatencyCompensation(float ClientTime) const
+{
+	// the client stamps with its GetServerWorldTimeSeconds, which trails the server by a full round trip plus up to
+	// ServerWorldTimeSecondsUpdateFrequency, so the timestamp only caps the half ping and never sets the amount
+	const float elapsed = FMath::Max(GetServerWorldTime() - ClientTime, 0.f);
+	return FMath::Clamp(FMath::Min(GetOneWayLatency(GetPlayerState()), elapsed), 0.f, MaxInputLatencyCompensation);
+}
+
 /* Only callable by server */
 void AHelloMultiplayerCharacter::SetCurrentHealth(float healthValue)
 {
 	if (GetLocalRole() == ROLE_Authority)
 	{
-		CurrentHealth = FMath::Clamp(healthValue, 0.f, MaxHealth);
+		TRACE_SHOT_STAGE(LastDamageShotId, SetHealth);
+		CurrentHealth = FMath::Clamp(healthValue, 0.f, GetMaxHealth());
 		Client_OnHealthUpdate();
 	}
 }
 
 float AHelloMultiplayerCharacter::TakeDamage(float DamageTaken, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	const float newHealth = CurrentHealth - DamageTaken;
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		const AHelloMultiplayerProjectile* projectile = Cast<AHelloMultiplayerProjectile>(DamageCauser);
+		LastDamageShotId = projectile ? projectile->ShotId : INDEX_NONE;
+		TRACE_SHOT_STAGE(LastDamageShotId, TakeDamage);
+	}
+
+	const float previousHealth = CurrentHealth;
+	const float newHealth = CurrentHealth - DamageTaken * Stats->GetValue(EStatAttribute::DamageTaken);
 	SetCurrentHealth(newHealth);
+
+	// scoreboard only counts damage that actually landed, dealt to someone else, and a kill only once
+	if (previousHealth > 0.f)
+	{
+		// maps run either the template game mode or AHelloMultiplayerGameModeBase, both record the same way
+		auto reportToScoreboard = [&](auto* gameMode)
+		{
+			if (EventInstigator != GetController())
+			{
+				gameMode->DamageDealt(EventInstigator, previousHealth - CurrentHealth);
+			}
+			if (CurrentHealth <= 0.f)
+			{
+				gameMode->ActorDied(this, EventInstigator);
+			}
+		};
+
+		if (AHelloMultiplayerGameModeBase* gameMode = GetWorld()->GetAuthGameMode<AHelloMultiplayerGameModeBase>())
+		{
+			reportToScoreboard(gameMode);
+		}
+		else if (AHelloMultiplayerGameMode* templateGameMode = GetWorld()->GetAuthGameMode<AHelloMultiplayerGameMode>())
+		{
+			reportToScoreboard(templateGameMode);
+		}
+	}
+
+	if (GetLocalRole() == ROLE_Authority && previousHealth > 0.f && CurrentHealth <= 0.f)
+	{
+		HandleKilled();
+	}
 	return newHealth;
 }
 
 void AHelloMultiplayerCharacter::OnRep_CurrentHealth()
 {
+	TRACE_SHOT_STAGE(LastDamageShotId, HealthReplicated);
 	Client_OnHealthUpdate();
 }
 
 void AHelloMultiplayerCharacter::OnRep_CurrentMana()
 {
+	Client_OnManaUpdate();
 }
 
 void AHelloMultiplayerCharacter::Client_OnHealthUpdate()
@@ -210,8 +396,8 @@ void AHelloMultiplayerCharacter::Client_OnHealthUpdate()
 
 		if (CurrentHealth <= 0)
 		{
+			// bIsDead is set by the server; setting it here too would swallow OnRep_IsDead
 			NET_LOG_LOCAL(FString::Printf(TEXT("Your health is below zero!")));
-			bIsDead = true;
 		}
 		
 	}
@@ -231,9 +417,17 @@ void AHelloMultiplayerCharacter::Client_OnManaUpdate()
 
 void AHelloMultiplayerCharacter::OnRep_IsDead()
 {
-	HandleDeath();
-	NET_LOG_LOCAL(FString::Printf(TEXT("You are now dead!")));
-	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AHelloMultiplayerCharacter::HandleRespawn, RespawnCooldown, false);
+	// both transitions come from the server, which decides when the respawn happens
+	if (bIsDead)
+	{
+		HandleDeath();
+		NET_LOG_LOCAL(FString::Printf(TEXT("You are now dead!")));
+	}
+	else
+	{
+		HandleRevive();
+		NET_LOG_LOCAL(FString::Printf(TEXT("You are now RESPAWNING!!")));
+	}
 }
 
 //called locally on each client
@@ -248,10 +442,46 @@ void AHelloMultiplayerCharacter::HandleDeath()
 	}
 }
 
+//called locally on each client
+void AHelloMultiplayerCharacter::HandleRevive()
+{
+	if (IsLocallyControlled())
+	{
+		//reactivate player controls
+		GetMovementComponent()->Activate();
+	}
+}
+
+/* Only callable by server */
 void AHelloMultiplayerCharacter::HandleRespawn()
 {
-	NET_LOG_LOCAL(FString::Printf(TEXT("You are now RESPAWNING!!")));
 	bIsDead = false;
+	// a listen server's own character gets no OnRep
+	HandleRevive();
+
+	// the refill isn't part of any shot
+	LastDamageShotId = INDEX_NONE;
+	SetCurrentHealth(GetMaxHealth());
+	CurrentMana = GetMaxMana();
+	Client_OnManaUpdate();
+}
+
+/* Only callable by server */
+void AHelloMultiplayerCharacter::HandleKilled()
+{
+	bIsDead = true;
+	HandleDeath();
+
+	// buffs and debuffs don't carry over a death; any frame before the respawn will do
+	UServerTaskScheduler* scheduler = GetWorld()->GetSubsystem<UServerTaskScheduler>();
+	scheduler->Schedule(this, [this]() { Stats->ClearModifiers(); }, EServerTaskPriority::Low, RespawnCooldown * 0.5f);
+
+	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AHelloMultiplayerCharacter::ScheduleRespawn, RespawnCooldown, false);
+}
+
+void AHelloMultiplayerCharacter::ScheduleRespawn()
+{
+	GetWorld()->GetSubsystem<UServerTaskScheduler>()->Schedule(this, [this]() { HandleRespawn(); }, EServerTaskPriority::High, RespawnMaxDelay);
 }
 
 
@@ -268,8 +498,11 @@ void AHelloMultiplayerCharacter::StartFire()
 		Blueprint_OnFire();
 		UWorld* World = GetWorld();
 		//manages requests sent to the server
-		World->GetTimerManager().SetTimer(FiringTimer, this, &AHelloMultiplayerCharacter::StopFire, FireRate,false);
-		Server_HandleFire();
+		World->GetTimerManager().SetTimer(FiringTimer, this, &AHelloMultiplayerCharacter::StopFire, Stats->GetValue(EStatAttribute::FireRate),false);
+		const int32 shotId = MakeShotId();
+		LastFiredShotId = shotId;
+		TRACE_SHOT_STAGE(shotId, ClientFire);
+		Server_HandleFire(GetServerWorldTime(), shotId);
 		bIsCasting1H = true;
 	} else
 	{
@@ -277,6 +510,15 @@ void AHelloMultiplayerCharacter::StartFire()
 	}
 }
 
+int32 AHelloMultiplayerCharacter::MakeShotId()
+{
+	// 12 bits of player ID, 19 bits of counter, so IDs stay positive and INDEX_NONE is never produced
+	const APlayerState* playerState = GetPlayerState();
+	const int32 playerId = playerState ? playerState->GetPlayerId() : 0;
+	ShotCounter = (ShotCounter + 1) & 0x7FFFF;
+	return ((playerId & 0xFFF) << 19) | ShotCounter;
+}
+
 void AHelloMultiplayerCharacter::StopFire()
 {
 	// NET_LOG("Firing finished");
@@ -288,15 +530,24 @@ void AHelloMultiplayerCharacter::Client_StartRoll()
 	UE_LOG(LogTemp, Warning, TEXT("Roll input receieved!"));
 	if (CanRoll()) {
 		bIsRolling = true;
-		GetWorld()->GetTimerManager().SetTimer(RollTimer, this, &AHelloMultiplayerCharacter::StopRoll, RollCooldown, false);
-		Server_SetRollDirection();
+		GetWorld()->GetTimerManager().SetTimer(RollTimer, this, &AHelloMultiplayerCharacter::StopRoll, Stats->GetValue(EStatAttribute::RollCooldown), false);
+		Server_SetRollDirection(GetServerWorldTime());
 	}
 }
 
 
 
-void AHelloMultiplayerCharacter::Server_SetRollDirection_Implementation()
+bool AHelloMultiplayerCharacter::Server_SetRollDirection_Validate(float ClientRollTime)
+{
+	return FMath::IsFinite(ClientRollTime);
+}
+
+void AHelloMultiplayerCharacter::Server_SetRollDirection_Implementation(float ClientRollTime)
 {
+	UpdateRpcBudgetRates();
+	if (!ConsumeRpcBudget(RollBudget, TEXT("Server_SetRollDirection")))
+		return;
+
 	if (!CanRoll())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Declining roll request on server"));
@@ -305,6 +556,13 @@ void AHelloMultiplayerCharacter::Server_SetRollDirection_Implementation()
 
 	RollDirection = GetActorRotation();
 	PlayAnimMontage(RollMontage);
+
+	// start the montage where the client already is, so the server isn't a full RTT behind the roll
+	UAnimInstance* AnimInstance = GetMesh() ? GetMesh()->GetAnimInstance() : nullptr;
+	if (AnimInstance && RollMontage)
+	{
+		AnimInstance->Montage_SetPosition(RollMontage, GetInputLatencyCompensation(ClientRollTime));
+	}
 	
 }
 
@@ -331,7 +589,8 @@ bool AHelloMultiplayerCharacter::CanRoll()
 
 	const bool bCanRoll = !bCurrentlyFalling && (bHasMoveInputRights || HasAuthority());
 	
-	NET_LOG_LOCAL(FString::Printf(TEXT("CanRoll() = %hs"), bCanRoll ? "true" : "false"));
+	// polled by the input buffer, so keep this off the screen
+	UE_LOG(LogTemp, Verbose, TEXT("CanRoll() = %hs"), bCanRoll ? "true" : "false");
 	
 	return bCanRoll;
 	
@@ -346,9 +605,20 @@ void AHelloMultiplayerCharacter::StopRoll()
 }
 
 
+bool AHelloMultiplayerCharacter::Server_HandleFire_Validate(float ClientFireTime, int32 ShotId)
+{
+	return FMath::IsFinite(ClientFireTime) && ShotId >= 0;
+}
+
 // called on server
-void AHelloMultiplayerCharacter::Server_HandleFire_Implementation()
+void AHelloMultiplayerCharacter::Server_HandleFire_Implementation(float ClientFireTime, int32 ShotId)
 {
+	TRACE_SHOT_STAGE(ShotId, ServerReceive);
+
+	// drop spam before doing any spawn work
+	UpdateRpcBudgetRates();
+	if (!ConsumeRpcBudget(FireBudget, TEXT("Server_HandleFire")))
+		return;
 
 	//spawn projectile
 	const FVector cameraForward = GetControlRotation().Vector() * 100.0f;
@@ -356,15 +626,231 @@ void AHelloMultiplayerCharacter::Server_HandleFire_Implementation()
 	const FVector spawnLocation = GetActorLocation() + cameraForward + actorUp;
 	const FRotator spawnRotation = GetControlRotation();
 
-	FActorSpawnParameters spawnParameters;
-	spawnParameters.Instigator = GetInstigator();
-	spawnParameters.Owner = this;
+	HM_LLM_SCOPE(Projectiles);
+	AHelloMultiplayerProjectile* spawnedProjectile = GetWorld()->SpawnActorDeferred<AHelloMultiplayerProjectile>(
+		ProjectileClass, FTransform(spawnRotation, spawnLocation), this, GetInstigator());
+	if (!spawnedProjectile)
+		return;
 
-	AHelloMultiplayerProjectile* spawnedProjectile = GetWorld()->SpawnActor<AHelloMultiplayerProjectile>(spawnLocation, spawnRotation, spawnParameters);
-	
-	
+	spawnedProjectile->ShotId = ShotId;
+	if (bEventReplicatedProjectiles)
+	{
+		spawnedProjectile->bIsEventReplicated = true;
+		spawnedProjectile->SetReplicates(false);
+	}
+	spawnedProjectile->FinishSpawning(FTransform(spawnRotation, spawnLocation));
+	TRACE_SHOT_STAGE(ShotId, ProjectileSpawn);
+
+	// advance the projectile to where it would be had the shot been applied at the client's fire time
+	const float latencyCompensation = GetInputLatencyCompensation(ClientFireTime);
+
+	// the spawn point is where the projectile was latencyCompensation seconds ago, clients catch up from there
+	if (bEventReplicatedProjectiles)
+	{
+		Multicast_ProjectileSpawned(spawnedProjectile->MakeSpawnEvent(latencyCompensation));
+	}
+
+	spawnedProjectile->FastForward(latencyCompensation);
+}
+
+void AHelloMultiplayerCharacter::Multicast_ProjectileSpawned_Implementation(const FProjectileSpawnEvent& SpawnEvent)
+{
+	// the server has the real projectile
+	if (GetNetMode() != NM_Client)
+		return;
+
+	const FTransform spawnTransform(SpawnEvent.Direction.Rotation(), SpawnEvent.Origin);
+
+	HM_LLM_SCOPE(Projectiles);
+	AHelloMultiplayerProjectile* simulatedProjectile = GetWorld()->SpawnActorDeferred<AHelloMultiplayerProjectile>(
+		ProjectileClass, spawnTransform, this, GetInstigator(), ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!simulatedProjectile)
+		return;
+
+	simulatedProjectile->ShotId = SpawnEvent.ShotId;
+	simulatedProjectile->MakeClientSimulated();
+	simulatedProjectile->FinishSpawning(spawnTransform);
+	simulatedProjectile->ProjectileMovementComponent->Velocity = SpawnEvent.Direction * SpawnEvent.Speed;
+
+	// the event is half of our round trip old on top of its age at send, catch up to where the server's projectile is now
+	const APlayerController* localController = GetWorld()->GetFirstPlayerController();
+	const float latency = GetOneWayLatency(localController ? localController->PlayerState : nullptr);
+	const float elapsed = FMath::Clamp(SpawnEvent.Age + latency, 0.f, MaxProjectileCatchUp);
+	simulatedProjectile->FastForward(elapsed);
+
+	SimulatedProjectiles.Add(SpawnEvent.ShotId, simulatedProjectile);
+}
+
+void AHelloMultiplayerCharacter::Multicast_ProjectileImpact_Implementation(int32 ShotId, FVector_NetQuantize Location)
+{
+	if (GetNetMode() != NM_Client)
+		return;
+
+	TWeakObjectPtr<AHelloMultiplayerProjectile> simulatedProjectile;
+	if (!SimulatedProjectiles.RemoveAndCopyValue(ShotId, simulatedProjectile))
+	{
+#if !UE_SERVER
+		// never saw the spawn (e.g. we weren't relevant yet), just play the impact
+		const AHelloMultiplayerProjectile* projectileDefaults = ProjectileClass ? ProjectileClass->GetDefaultObject<AHelloMultiplayerProjectile>() : nullptr;
+		if (projectileDefaults)
+		{
+			UGameplayStatics::SpawnEmitterAtLocation(this, projectileDefaults->ExplosionEffect, Location, FRotator::ZeroRotator, true,
+				EPSCPoolMethod::AutoRelease);
+		}
+#endif
+		return;
+	}
+
+	// a stale pointer means the local copy already hit a wall and exploded
+	if (simulatedProjectile.IsValid())
+	{
+		simulatedProjectile->SetActorLocation(Location);
+		simulatedProjectile->Destroy();
+	}
+}
+
+
+// called on client
+void AHelloMultiplayerCharacter::StartCast()
+{
+	// the server has the final say on mana, this only saves sending casts that would be rejected
+	if (bIsCasting1H || CurrentMana < SpellManaCost)
+		return;
+
+	Blueprint_OnCast();
+	GetWorld()->GetTimerManager().SetTimer(FiringTimer, this, &AHelloMultiplayerCharacter::StopFire, Stats->GetValue(EStatAttribute::FireRate), false);
+	Server_CastSpell();
+	bIsCasting1H = true;
+}
+
+// called on server
+void AHelloMultiplayerCharacter::Server_CastSpell_Implementation()
+{
+	if (!ConsumeRpcBudget(SpellBudget, TEXT("Server_CastSpell")))
+		return;
+
+	// the client locks casting for FireRate seconds after each cast; hold it to that here, less a little for jitter
+	const float now = GetWorld()->GetTimeSeconds();
+	const float cooldown = Stats->GetValue(EStatAttribute::FireRate) - SpellCooldownTolerance;
+	if (now - LastServerCastTime < cooldown)
+	{
+		INC_DWORD_STAT(STAT_SpellCastsRejected);
+		UE_LOG(LogTemp, Verbose, TEXT("Rejecting cast from %s, %f s since the last one"), *GetFName().ToString(), now - LastServerCastTime);
+		return;
+	}
+
+	if (bIsDead || CurrentMana < SpellManaCost)
+	{
+		INC_DWORD_STAT(STAT_SpellCastsRejected);
+		UE_LOG(LogTemp, Verbose, TEXT("Rejecting cast from %s, %f mana of %f"), *GetFName().ToString(), CurrentMana, SpellManaCost);
+		return;
+	}
+
+	LastServerCastTime = now;
+	CurrentMana -= SpellManaCost;
+	Client_OnManaUpdate();
+	StartManaRegen();
+
+	const FVector direction = GetControlRotation().Vector();
+	const FVector start = GetActorLocation() + GetActorUpVector() * 50.f + direction * 100.f;
+
+	FSpellTraceRequest request;
+	request.Mode = SpellMode;
+	request.Start = start;
+	request.End = start + direction * SpellRange;
+	request.BeamRadius = BeamRadius;
+	request.Damage = SpellDamage;
+	request.Caster = this;
+	request.InstigatorController = GetController();
+	GetWorld()->GetSubsystem<USpellTraceSubsystem>()->StartTrace(request);
 }
 
+void AHelloMultiplayerCharacter::StartManaRegen()
+{
+	if (CurrentMana < GetMaxMana() && !GetWorldTimerManager().IsTimerActive(ManaRegenTimer))
+	{
+		GetWorldTimerManager().SetTimer(ManaRegenTimer, this, &AHelloMultiplayerCharacter::RegenManaStep, ManaRegenInterval, true);
+	}
+}
+
+void AHelloMultiplayerCharacter::OnStatChanged(EStatAttribute Attribute, float NewValue)
+{
+	// a raised max is left for regen or the respawn to fill, only a lowered one needs clamping
+	if (Attribute == EStatAttribute::MaxHealth && CurrentHealth > NewValue)
+	{
+		CurrentHealth = NewValue;
+		Client_OnHealthUpdate();
+	}
+	else if (Attribute == EStatAttribute::MaxMana)
+	{
+		if (CurrentMana > NewValue)
+		{
+			CurrentMana = NewValue;
+			Client_OnManaUpdate();
+		}
+		StartManaRegen();
+	}
+}
+
+void AHelloMultiplayerCharacter::RegenManaStep()
+{
+	// dead characters keep their mana where it is until they respawn
+	if (bIsDead)
+		return;
+
+	CurrentMana = FMath::Min(CurrentMana + ManaRegenRate * ManaRegenInterval, GetMaxMana());
+	Client_OnManaUpdate();
+
+	if (CurrentMana >= GetMaxMana())
+	{
+		GetWorldTimerManager().ClearTimer(ManaRegenTimer);
+	}
+}
+
+bool AHelloMultiplayerCharacter::ConsumeRpcBudget(FRpcBudget& Budget, const TCHAR* RpcName)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Budget.TryConsume(Now))
+		return true;
+
+	AbuseScore = FMath::Max(0.f, AbuseScore - (Now - LastAbuseUpdateTime) * AbuseDecayRate) + 1.f;
+	LastAbuseUpdateTime = Now;
+
+	if (!bFlaggedForAbuse && AbuseScore >= AbuseFlagThreshold)
+	{
+		bFlaggedForAbuse = true;
+		UE_LOG(LogTemp, Warning, TEXT("%s is flooding %s (%d dropped), flagging connection"), *GetFName().ToString(), RpcName, Budget.DroppedCount);
+	}
+
+	if (AbuseKickThreshold > 0.f && AbuseScore >= AbuseKickThreshold)
+	{
+		APlayerController* PlayerController = Cast<APlayerController>(Controller);
+		AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+		if (PlayerController && GameMode && GameMode->GameSession)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Kicking %s for exceeding the RPC budget of %s"), *GetFName().ToString(), RpcName);
+			GameMode->GameSession->KickPlayer(PlayerController, FText::FromString(TEXT("Exceeded server RPC budget")));
+			AbuseScore = 0.f;
+		}
+	}
+
+	return false;
+}
+
+void AHelloMultiplayerCharacter::UpdateRpcBudgetRates()
+{
+	// FireRate and RollCooldown are seconds per action, so buffs that speed them up raise the budget with them
+	FireBudget.RefillRate = RpcBudgetHeadroom / FMath::Max(Stats->GetValue(EStatAttribute::FireRate), KINDA_SMALL_NUMBER);
+	RollBudget.RefillRate = RpcBudgetHeadroom / FMath::Max(Stats->GetValue(EStatAttribute::RollCooldown), KINDA_SMALL_NUMBER);
+}
+
+void AHelloMultiplayerCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// never compared or sent in Shipping
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AHelloMultiplayerCharacter, LastDamageShotId, HM_WITH_SHOT_IDS);
+}
 
 void AHelloMultiplayerCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
@@ -372,6 +858,8 @@ void AHelloMultiplayerCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProp
 
 	//Replicate current health
 	DOREPLIFETIME(AHelloMultiplayerCharacter, CurrentHealth);
+	DOREPLIFETIME(AHelloMultiplayerCharacter, CurrentMana);
+	DOREPLIFETIME(AHelloMultiplayerCharacter, LastDamageShotId);
 	DOREPLIFETIME(AHelloMultiplayerCharacter, bIsDead);
 	DOREPLIFETIME(AHelloMultiplayerCharacter, RollDirection);
 }
@@ -3,8 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Components/WidgetComponent.h"
 #include "GameFramework/Character.h"
+#include "HelloMultiplayerProjectile.h"
+#include "Combat/SpellTraceSubsystem.h"
+#include "Networking/RpcBudget.h"
+#include "Stats/Stat.h"
 #include "HelloMultiplayerCharacter.generated.h"
 
 UCLASS(config=Game)
@@ -12,21 +15,30 @@ class AHelloMultiplayerCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
-	/** Camera boom positioning the camera behind the character */
+	friend class UDuelBotComponent;
+
+	/** Camera boom positioning the camera behind the character. Null in server-only builds. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class USpringArmComponent* CameraBoom;
 
-	/** Follow camera */
+	/** Follow camera. Null in server-only builds. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UCameraComponent* FollowCamera;
+
+	/** Buffs and debuffs. Max health, max mana, fire rate, roll cooldown and incoming damage are read from here. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Stats, meta = (AllowPrivateAccess = "true"))
+	UStat* Stats;
 	
 public:
 
-	AHelloMultiplayerCharacter();
+	AHelloMultiplayerCharacter(const FObjectInitializer& ObjectInitializer);
 
 	/**responsible for replicating any properties we designate with "Replicated"
 	enables us to configure how a property will replicate*/
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	virtual void Tick(float DeltaSeconds) override;
 	
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
@@ -40,11 +52,11 @@ public:
 	// UHealthBar* HealthBar = nullptr;
 	
 	UFUNCTION(BlueprintPure, Category="Health")
-	FORCEINLINE float GetMaxHealth() const {return MaxHealth;}
+	FORCEINLINE float GetMaxHealth() const {return Stats->GetValue(EStatAttribute::MaxHealth);}
 	UFUNCTION(BlueprintPure, Category="Health")
     FORCEINLINE float GetCurrentHealth() const {return CurrentHealth;}
 	UFUNCTION(BlueprintPure, Category = "Spell Casting")
-	FORCEINLINE float GetMaxMana() const { return MaxMana; };
+	FORCEINLINE float GetMaxMana() const { return Stats->GetValue(EStatAttribute::MaxMana); };
 	UFUNCTION(BlueprintPure, Category = "Spell Casting")
 	FORCEINLINE float GetCurrentMana() const { return CurrentMana; };
 
@@ -63,10 +75,17 @@ public:
 	UAnimMontage* AttackMontage;
 	UPROPERTY(EditAnywhere)
 	UAnimMontage* DeathMontage;
+
+	/** Tells clients where an event-replicated projectile of this character hit, so they can end their local copy. */
+	UFUNCTION(NetMulticast, Reliable)
+	void Multicast_ProjectileImpact(int32 ShotId, FVector_NetQuantize Location);
 	
 protected:
 
-	virtual void BeginPlay() override;
+	virtual void PostInitializeComponents() override;
+
+	/** Called on the owning client when possessed. Starts the duel bot when running with -DuelBot. */
+	virtual void PawnClientRestart() override;
 	
 	/** Resets HMD orientation in VR. */
 	void OnResetVR();
@@ -101,7 +120,7 @@ protected:
 
 	// START HEALTH / DEATH CODE
 	
-	/** The player's maximum health. This is the highest that their health can be, and the value that their health starts at when spawned.*/
+	/** The player's base maximum health, before modifiers. Use GetMaxHealth() for the effective value.*/
 	UPROPERTY(EditAnywhere, Category="Health")
 	float MaxHealth = 100.f;
 	UPROPERTY(EditAnywhere, Category = "Spell Casting")
@@ -113,6 +132,13 @@ protected:
 	UPROPERTY(ReplicatedUsing = OnRep_CurrentMana)
 	float CurrentMana;
 
+	/**
+	 * Shot ID of the projectile that last damaged this character, INDEX_NONE if the damage didn't come from a shot.
+	 * Diagnostic only: replicated only when HM_WITH_SHOT_IDS, see PreReplication.
+	 */
+	UPROPERTY(Replicated)
+	int32 LastDamageShotId = INDEX_NONE;
+
 	UFUNCTION()
 	void OnRep_CurrentHealth();
 	UFUNCTION()
@@ -137,15 +163,31 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Death")
 	float RespawnCooldown = 3.f;
 
+	/** How long after RespawnCooldown the server may defer the respawn when many players die at once. */
+	UPROPERTY(EditAnywhere, Category="Death")
+	float RespawnMaxDelay = 0.2f;
+
 	/**
-	 * Response to IsDead being updated
+	 * Response to IsDead being set
 	 */
 	UFUNCTION()
 	void HandleDeath();
 
+	/**
+	 * Response to IsDead being cleared
+	 */
+	void HandleRevive();
+
+	/** Server side of a respawn: clears bIsDead and refills health. Run through the UServerTaskScheduler. */
 	UFUNCTION()
 	void HandleRespawn();
 
+	/** Server side of a death: sets bIsDead and queues the stat reset and respawn on the UServerTaskScheduler. */
+	void HandleKilled();
+
+	UFUNCTION()
+	void ScheduleRespawn();
+
 	// END HEALTH / DEATH CODE
 
 	// START WEAPON CODE
@@ -153,7 +195,7 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category="Gameplay|Combat")
 	TSubclassOf<class AHelloMultiplayerProjectile> ProjectileClass;
 
-	/** Delay between shots in seconds. Used to control fire rate for our test projectile, but also to prevent an overflow of server functions from binding SpawnProjectile directly to input.*/
+	/** Base delay between shots in seconds, before modifiers. Used to control fire rate for our test projectile, but also to prevent an overflow of server functions from binding SpawnProjectile directly to input.*/
 	UPROPERTY(EditDefaultsOnly, Category="Gameplay|Combat")
 	float FireRate;
 
@@ -172,9 +214,36 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Gameplay|Combat")
     void StopFire();  
 
-	/** Server function for spawning projectiles.*/
-	UFUNCTION(Server, Reliable)
-    void Server_HandleFire();
+	/** Server function for spawning projectiles. Rate limited by FireBudget.
+	 * @param ClientFireTime	Server world time (as estimated by the client) at which the shot was fired
+	 * @param ShotId			ID assigned by the shooting client, used to correlate the shot across machines */
+	UFUNCTION(Server, Reliable, WithValidation)
+    void Server_HandleFire(float ClientFireTime, int32 ShotId);
+
+	/** Counter for shots fired by this client. Combined with the player ID in MakeShotId. */
+	int32 ShotCounter = 0;
+
+	/** ID of the last shot fired by this client, INDEX_NONE before the first shot. */
+	int32 LastFiredShotId = INDEX_NONE;
+
+	/** Returns an ID for the next shot that is unique across all players of the match. */
+	int32 MakeShotId();
+
+	/** If true, projectiles aren't replicated as actors. Clients get a spawn and an impact event per projectile
+	 * and simulate the flight in between locally. */
+	UPROPERTY(EditDefaultsOnly, Category="Gameplay|Combat")
+	bool bEventReplicatedProjectiles = false;
+
+	/** Most a client will fast-forward a simulated projectile to catch up with the server, in seconds. */
+	UPROPERTY(EditDefaultsOnly, Category="Gameplay|Combat")
+	float MaxProjectileCatchUp = 0.5f;
+
+	/** Starts the local simulation of an event-replicated projectile on clients. */
+	UFUNCTION(NetMulticast, Reliable)
+	void Multicast_ProjectileSpawned(const FProjectileSpawnEvent& SpawnEvent);
+
+	/** Client: local simulations of this character's event-replicated projectiles, by shot ID. */
+	TMap<int32, TWeakObjectPtr<AHelloMultiplayerProjectile>> SimulatedProjectiles;
 
 	/** A timer handle used for providing the fire rate delay in-between spawns.*/
 	UPROPERTY(Transient)
@@ -182,6 +251,70 @@ protected:
 
 	// END WEAPON CODE
 
+	// START SPELL CODE
+
+	/** Whether StartCast fires a line trace or a thicker sphere sweep. */
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	ESpellCastMode SpellMode = ESpellCastMode::Hitscan;
+
+	/** Mana spent per cast. The server rejects casts it can't pay for. */
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	float SpellManaCost = 20.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	float SpellDamage = 15.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	float SpellRange = 5000.f;
+
+	/** Radius of the sweep in Beam mode. */
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	float BeamRadius = 20.f;
+
+	/** Mana regained per second, on the server. */
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	float ManaRegenRate = 5.f;
+
+	/** Seconds between mana regen steps. Each step changes CurrentMana once, so it replicates at this rate at most. */
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	float ManaRegenInterval = 0.5f;
+
+	UPROPERTY(Transient)
+	FTimerHandle ManaRegenTimer;
+
+	/** Server only. Starts the regen timer if mana is below max and it isn't running yet. */
+	void StartManaRegen();
+
+	/** Server only. Adds one interval's worth of mana, and stops the timer once mana is full. */
+	void RegenManaStep();
+
+	/** Server only. Keeps current health and mana within their max when a stat modifier changes it. */
+	void OnStatChanged(EStatAttribute Attribute, float NewValue);
+
+	/** Server-side budget for Server_CastSpell. */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking|Budget")
+	FRpcBudget SpellBudget = FRpcBudget(6.f, 3.f);
+
+	/** Function for casting the hitscan spell. Shares the bIsCasting1H lock and fire rate with StartFire. */
+	UFUNCTION(BlueprintCallable, Category = "Spell Casting")
+	void StartCast();
+
+	UFUNCTION(BlueprintImplementableEvent)
+	void Blueprint_OnCast();
+
+	/** Seconds a cast may arrive early against the FireRate cooldown, to allow for network jitter. */
+	UPROPERTY(EditDefaultsOnly, Category = "Spell Casting")
+	float SpellCooldownTolerance = 0.05f;
+
+	/** Server world time of the last accepted cast. */
+	float LastServerCastTime = -BIG_NUMBER;
+
+	/** Server function for casting. Checks the cast cooldown and spends mana, then starts an async trace. */
+	UFUNCTION(Server, Reliable)
+	void Server_CastSpell();
+
+	// END SPELL CODE
+
 	// START DODGE-ROLL CODE
 	UPROPERTY(ReplicatedUsing = OnRep_RollDirection)
 	FRotator RollDirection;
@@ -194,8 +327,9 @@ protected:
 	void Client_StartRoll();
 	UFUNCTION(BlueprintCallable, Category = "Gameplay|Movement")
 	bool CanRoll();
-	UFUNCTION(Server, Reliable)
-	void Server_SetRollDirection();
+	/** Server function for starting a roll. Rate limited by RollBudget. */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_SetRollDirection(float ClientRollTime);
 	UFUNCTION()
 	void OnRep_RollDirection();
 	UFUNCTION(Category="Gameplay|Movement")
@@ -208,11 +342,104 @@ protected:
 	FTimerHandle RollTimer;
 
 	// END DODGE-ROLL CODE
+
+	// START INPUT BUFFER CODE
+
+	/** How long (in seconds) a fire or roll press stays buffered while the action is unavailable. */
+	UPROPERTY(EditAnywhere, Category="Input")
+	float InputBufferWindow = 0.2f;
+
+	/** Upper bound (in seconds) on how far the server will fast-forward an action to make up for the client's latency. */
+	UPROPERTY(EditAnywhere, Category="Input")
+	float MaxInputLatencyCompensation = 0.25f;
+
+	/**
+	 * Control rotation's yaw basis, computed once per frame and shared by MoveForward and MoveRight.
+	 * The axis handlers run in the controller's tick, which the movement component waits for, so input added
+	 * there is consumed the same frame.
+	 */
+	FVector InputForward = FVector::ForwardVector;
+	FVector InputRight = FVector::RightVector;
+	uint64 InputBasisFrame = 0;
+
+	/** Local world time of a press waiting for its action to become ready, negative when nothing is buffered. */
+	float BufferedFirePressTime = -1.f;
+	float BufferedRollPressTime = -1.f;
+
+	/** Input handlers for Fire and Roll. Record the press so it fires on the first frame the action is ready. */
+	void OnFirePressed();
+	void OnRollPressed();
+
+	/** Refreshes InputForward and InputRight if they weren't computed this frame. */
+	void UpdateInputYawBasis();
+
+	/** Consumes buffered presses whose action is ready and drops those older than InputBufferWindow. */
+	void SampleBufferedActions();
+
+	/** Server world time as seen by this machine. Used to timestamp actions sent to the server. */
+	float GetServerWorldTime() const;
+
+	/** Half the ping of a player, in seconds. Zero without a player state. */
+	static float GetOneWayLatency(const class APlayerState* PlayerState);
+
+	/**
+	 * Seconds to fast-forward a client action by on the server: half this player's ping, but no more than has elapsed
+	 * since the client's timestamp, clamped to MaxInputLatencyCompensation.
+	 */
+	float GetInputLatencyCompensation(float ClientTime) const;
+
+	// END INPUT BUFFER CODE
+
+	// START RPC BUDGET CODE
+
+	/** Server-side budget for Server_HandleFire. RefillRate follows the effective fire rate, see UpdateRpcBudgetRates. */
+	UPROPERTY(EditDefaultsOnly, Category="Networking|Budget")
+	FRpcBudget FireBudget = FRpcBudget(6.f, 3.f);
+
+	/** Server-side budget for Server_SetRollDirection. RefillRate follows the effective roll cooldown. */
+	UPROPERTY(EditDefaultsOnly, Category="Networking|Budget")
+	FRpcBudget RollBudget = FRpcBudget(2.f, 2.f);
+
+	/** How many times the stat-derived fire and roll rates a client may call their RPCs, to absorb network jitter. */
+	UPROPERTY(EditDefaultsOnly, Category="Networking|Budget")
+	float RpcBudgetHeadroom = 1.5f;
+
+	/** Each dropped RPC adds 1 to the abuse score, which decays by this much per second. */
+	UPROPERTY(EditDefaultsOnly, Category="Networking|Budget")
+	float AbuseDecayRate = 1.f;
+
+	/** Abuse score at which the connection is flagged in the log. */
+	UPROPERTY(EditDefaultsOnly, Category="Networking|Budget")
+	float AbuseFlagThreshold = 10.f;
+
+	/** Abuse score at which the owning player is kicked. Zero or less disables kicking. */
+	UPROPERTY(EditDefaultsOnly, Category="Networking|Budget")
+	float AbuseKickThreshold = 50.f;
+
+	UPROPERTY(VisibleInstanceOnly, Category="Networking|Budget")
+	float AbuseScore = 0.f;
+
+	float LastAbuseUpdateTime = 0.f;
+	bool bFlaggedForAbuse = false;
+
+	/**
+	 * Server only. Charges one call of an RPC against its budget.
+	 * RPCs are only accepted from the owning connection, so this pawn's budgets are that connection's budgets.
+	 * @return false if the call is over budget and must be dropped
+	 */
+	bool ConsumeRpcBudget(FRpcBudget& Budget, const TCHAR* RpcName);
+
+	/** Server only. Derives the fire and roll budgets' refill rates from the current FireRate and RollCooldown stats. */
+	void UpdateRpcBudgetRates();
+
+	// END RPC BUDGET CODE
 	
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns Stats subobject **/
+	FORCEINLINE UStat* GetStats() const { return Stats; }
 };
 
@@ -2,6 +2,10 @@
 
 #include "HelloMultiplayerGameMode.h"
 #include "HelloMultiplayerCharacter.h"
+#include "Diagnostics/HelloMultiplayerMemory.h"
+#include "GameModes/HelloMultiplayerGameState.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerState.h"
 #include "UObject/ConstructorHelpers.h"
 
 AHelloMultiplayerGameMode::AHelloMultiplayerGameMode()
@@ -12,4 +16,35 @@ AHelloMultiplayerGameMode::AHelloMultiplayerGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	// the scoreboard lives on the game state, so this mode needs it as much as AHelloMultiplayerGameModeBase does
+	GameStateClass = AHelloMultiplayerGameState::StaticClass();
+}
+
+APawn* AHelloMultiplayerGameMode::SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot)
+{
+	// same tagging as AHelloMultiplayerGameModeBase, whichever of the two the map uses
+	HM_LLM_SCOPE(Characters);
+	return Super::SpawnDefaultPawnFor_Implementation(NewPlayer, StartSpot);
+}
+
+void AHelloMultiplayerGameMode::ActorDied(AActor* DeadActor, AController* Killer)
+{
+	const APawn* DeadPawn = Cast<APawn>(DeadActor);
+	AHelloMultiplayerGameState* HMGameState = GetGameState<AHelloMultiplayerGameState>();
+	if (!DeadPawn || !HMGameState)
+	{
+		return;
+	}
+
+	HMGameState->AddKill(Killer ? Killer->GetPlayerState<APlayerState>() : nullptr, DeadPawn->GetPlayerState());
+}
+
+void AHelloMultiplayerGameMode::DamageDealt(AController* Dealer, float Damage)
+{
+	AHelloMultiplayerGameState* HMGameState = GetGameState<AHelloMultiplayerGameState>();
+	if (Dealer && HMGameState)
+	{
+		HMGameState->AddDamage(Dealer->GetPlayerState<APlayerState>(), Damage);
+	}
 }
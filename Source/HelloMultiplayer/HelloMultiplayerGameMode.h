@@ -13,6 +13,14 @@ class AHelloMultiplayerGameMode : public AGameModeBase
 
 public:
 	AHelloMultiplayerGameMode();
+
+	virtual APawn* SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot) override;
+
+	/** Server: records a death on the scoreboard and kill feed. Killer may be null. */
+	void ActorDied(AActor* DeadActor, AController* Killer);
+
+	/** Server: credits damage to the dealer's scoreboard row. */
+	void DamageDealt(AController* Dealer, float Damage);
 };
 
 
@@ -2,6 +2,10 @@
 
 
 #include "HelloMultiplayerProjectile.h"
+#include "Diagnostics/HelloMultiplayerMemory.h"
+#include "Diagnostics/ShotTrace.h"
+#include "HelloMultiplayerCharacter.h"
+#include "Combat/AreaDamageSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/DamageType.h"
@@ -13,6 +17,8 @@
 // Sets default values
 AHelloMultiplayerProjectile::AHelloMultiplayerProjectile()
 {
+	HM_LLM_SCOPE(Projectiles);
+
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 	bReplicates = true;
@@ -30,10 +36,13 @@ AHelloMultiplayerProjectile::AHelloMultiplayerProjectile()
 	}
 	
 	//Definition for the Mesh that will serve as our visual representation.
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshObj(TEXT("/Game/Meshes/Rock/Rock"));
 	StaticMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
 	StaticMesh->SetupAttachment(RootComponent);
 
+#if !UE_SERVER
+	//Visual assets are never rendered on a dedicated server, so server-only builds don't load them.
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshObj(TEXT("/Game/Meshes/Rock/Rock"));
+
 	//Set the Static Mesh and its position/scale if we successfully found a mesh asset to use.
 	if (MeshObj.Succeeded())
 	{
@@ -47,6 +56,7 @@ AHelloMultiplayerProjectile::AHelloMultiplayerProjectile()
 	{
 		ExplosionEffect = DefaultExplosionEffect.Object;
 	}
+#endif
 
 	//Definition for the Projectile Movement Component.
 	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovement"));
@@ -59,6 +69,9 @@ AHelloMultiplayerProjectile::AHelloMultiplayerProjectile()
 	//Set damage type params
 	DamageType = UDamageType::StaticClass();
 	Damage = 10.0f;
+
+	//Misses are cleaned up instead of flying forever
+	InitialLifeSpan = 5.0f;
 	
 }
 
@@ -76,12 +89,44 @@ void AHelloMultiplayerProjectile::Tick(float DeltaTime)
 
 }
 
+void AHelloMultiplayerProjectile::MakeClientSimulated()
+{
+	bIsEventReplicated = true;
+	SetReplicates(false);
+	// the server decides what was hit, the local copy only has to stop at walls
+	SphereComponent->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+}
+
+FProjectileSpawnEvent AHelloMultiplayerProjectile::MakeSpawnEvent(float Age) const
+{
+	FProjectileSpawnEvent Event;
+	Event.Origin = GetActorLocation();
+	Event.Direction = GetActorForwardVector();
+	Event.Speed = ProjectileMovementComponent->Velocity.Size();
+	Event.Age = Age;
+	Event.ShotId = ShotId;
+	return Event;
+}
+
+void AHelloMultiplayerProjectile::FastForward(float Seconds)
+{
+	if (Seconds <= 0.f)
+	{
+		return;
+	}
+
+	const FVector Delta = ProjectileMovementComponent->Velocity * Seconds;
+	SetActorLocation(GetActorLocation() + Delta, true);
+}
+
 //particle emitter doesn't replicated, but destruction is... so this call is synced indirectly
 void AHelloMultiplayerProjectile::Destroyed()
 {
+#if !UE_SERVER
 	FVector spawnLocation = GetActorLocation();
 	UGameplayStatics::SpawnEmitterAtLocation(this, ExplosionEffect, spawnLocation, FRotator::ZeroRotator, true,
 		EPSCPoolMethod::AutoRelease);
+#endif
 }
 
 /*
@@ -93,11 +138,58 @@ void AHelloMultiplayerProjectile::Destroyed()
 void AHelloMultiplayerProjectile::OnProjectileImpact(UPrimitiveComponent* HitComponent, AActor* OtherActor,
 	UPrimitiveComponent* OtherComp, FVector ImpulseNormal, const FHitResult& Hit)
 {
-	if (OtherActor)
+	// local stand-in for a server projectile, see MakeClientSimulated
+	if (bIsEventReplicated && GetNetMode() == NM_Client)
+	{
+		Destroy();
+		return;
+	}
+
+	TRACE_SHOT_STAGE(ShotId, ProjectileImpact);
+
+	if (ExplosionRadius > 0.f)
+	{
+		// resolved with every other explosion of this frame, see UAreaDamageSubsystem
+		FAreaDamageRequest Request;
+		Request.Origin = GetActorLocation();
+		Request.Radius = ExplosionRadius;
+		Request.BaseDamage = Damage;
+		Request.MinimumDamage = ExplosionMinimumDamage;
+		Request.bRequireLineOfSight = bExplosionNeedsLineOfSight;
+		Request.DamageCauser = this;
+		Request.InstigatorController = GetInstigatorController();
+		Request.DamageType = DamageType;
+		GetWorld()->GetSubsystem<UAreaDamageSubsystem>()->QueueExplosion(Request);
+	}
+	else if (OtherActor)
 	{
 		UGameplayStatics::ApplyPointDamage(OtherActor, Damage, ImpulseNormal, Hit, GetInstigator()->Controller, this, DamageType);
 	}
 
+	NotifyClientsOfEnd();
 	Destroy();
 }
 
+void AHelloMultiplayerProjectile::LifeSpanExpired()
+{
+	// a miss ends like a hit for the clients' local copies, without the damage
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		NotifyClientsOfEnd();
+	}
+
+	Super::LifeSpanExpired();
+}
+
+void AHelloMultiplayerProjectile::NotifyClientsOfEnd()
+{
+	// clients only know about this projectile through its owner's events
+	if (bIsEventReplicated)
+	{
+		if (AHelloMultiplayerCharacter* Character = Cast<AHelloMultiplayerCharacter>(GetOwner()))
+		{
+			Character->Multicast_ProjectileImpact(ShotId, GetActorLocation());
+		}
+	}
+}
+
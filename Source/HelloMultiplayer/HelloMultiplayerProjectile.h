@@ -4,8 +4,32 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
 #include "HelloMultiplayerProjectile.generated.h"
 
+/** Everything a client needs to simulate a projectile's straight-line flight locally. */
+USTRUCT()
+struct FProjectileSpawnEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize10 Origin;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	UPROPERTY()
+	float Speed = 0.f;
+
+	/** Seconds since the projectile was at Origin, when the server sent the event. */
+	UPROPERTY()
+	float Age = 0.f;
+
+	UPROPERTY()
+	int32 ShotId = INDEX_NONE;
+};
+
 UCLASS()
 class HELLOMULTIPLAYER_API AHelloMultiplayerProjectile : public AActor
 {
@@ -41,11 +65,35 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Damage")
 	float Damage;
 
+	// if greater than zero, impacts explode and damage every character in this radius instead of only what was hit
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Damage")
+	float ExplosionRadius = 0.f;
+
+	// damage at the edge of ExplosionRadius, Damage being the damage at the center
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Damage")
+	float ExplosionMinimumDamage = 0.f;
+
+	// if true, characters behind world geometry are sheltered from the explosion
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Damage")
+	bool bExplosionNeedsLineOfSight = true;
+
+	// ID of the shot that spawned this projectile, see AHelloMultiplayerCharacter::MakeShotId
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category="Damage")
+	int32 ShotId = INDEX_NONE;
+
+	// Server: the projectile isn't replicated, clients are told about it through spawn/impact events on the owner.
+	// Client: the projectile is a local simulation of one of those, it deals no damage and ignores pawns.
+	bool bIsEventReplicated = false;
+
 protected:
 	
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 	virtual void Destroyed() override;
+	virtual void LifeSpanExpired() override;
+
+	// Server: sends the impact event for an event-replicated projectile, so clients end their local copy
+	void NotifyClientsOfEnd();
 
 	UFUNCTION()
 	void OnProjectileImpact(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector ImpulseNormal, const FHitResult& Hit);
@@ -55,4 +103,13 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	// Moves the projectile along its velocity by Seconds, sweeping so anything in the way still triggers an impact
+	void FastForward(float Seconds);
+
+	// Turns a locally spawned projectile into the visual stand-in for a server projectile. Call before FinishSpawning.
+	void MakeClientSimulated();
+
+	// Builds the event clients use to simulate this projectile, see AHelloMultiplayerCharacter::Multicast_ProjectileSpawned
+	FProjectileSpawnEvent MakeSpawnEvent(float Age) const;
+
 };
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HelloMultiplayerMovementComponent.h"
+#include "HelloMultiplayer.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Proxy Movement"), STAT_ProxyMovement, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proxies Full"), STAT_ProxiesFull, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proxies Interpolated"), STAT_ProxiesInterpolated, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proxies Dormant"), STAT_ProxiesDormant, STATGROUP_HelloMultiplayer);
+
+static TAutoConsoleVariable<int32> CVarProxyMovementLOD(
+	TEXT("HelloMultiplayer.ProxyMovementLOD"),
+	1,
+	TEXT("0: every simulated proxy runs full movement simulation. 1: distance and visibility based LOD."));
+
+UHelloMultiplayerMovementComponent::UHelloMultiplayerMovementComponent()
+{
+}
+
+void UHelloMultiplayerMovementComponent::SimulatedTick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProxyMovement);
+
+	UpdateProxyLOD();
+
+	switch (ProxyLOD)
+	{
+	case EProxyMovementLOD::Full:
+		INC_DWORD_STAT(STAT_ProxiesFull);
+		Super::SimulatedTick(DeltaSeconds);
+		break;
+
+	case EProxyMovementLOD::Interpolated:
+		INC_DWORD_STAT(STAT_ProxiesInterpolated);
+		if (IsSimulatingRootMotion())
+		{
+			// montages like the roll move the proxy locally from root motion; only Super steps that, including the
+			// frame after the montage ends
+			if (!bWasSimulatingRootMotion)
+			{
+				// the floor wasn't tracked while interpolating
+				bForceNextFloorCheck = true;
+			}
+			Super::SimulatedTick(DeltaSeconds);
+			break;
+		}
+		// the capsule sits at the last replicated location; only the mesh offset is smoothed towards it
+		SmoothClientPosition(DeltaSeconds);
+		break;
+
+	case EProxyMovementLOD::Dormant:
+		INC_DWORD_STAT(STAT_ProxiesDormant);
+		// nobody sees the mesh, so snap it onto the capsule; it's in the right place when it becomes visible again
+		SnapMeshToCapsule();
+		break;
+	}
+}
+
+void UHelloMultiplayerMovementComponent::SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation)
+{
+	Super::SmoothCorrection(OldLocation, OldRotation, NewLocation, NewRotation);
+
+	// a dormant proxy only ticks every DormantTickInterval, so snap as updates arrive instead of waiting for the
+	// next tick; otherwise the first frames after it comes back into view show a stale offset
+	if (ProxyLOD == EProxyMovementLOD::Dormant)
+	{
+		SnapMeshToCapsule();
+	}
+}
+
+bool UHelloMultiplayerMovementComponent::IsSimulatingRootMotion() const
+{
+	return CharacterOwner && (CharacterOwner->IsPlayingNetworkedRootMotionMontage() || CurrentRootMotion.HasActiveRootMotionSources() || bWasSimulatingRootMotion);
+}
+
+void UHelloMultiplayerMovementComponent::SnapMeshToCapsule()
+{
+	if (FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character())
+	{
+		ClientData->MeshTranslationOffset = FVector::ZeroVector;
+		ClientData->MeshRotationOffset = ClientData->MeshRotationTarget;
+		SmoothClientPosition_UpdateVisuals();
+	}
+}
+
+void UHelloMultiplayerMovementComponent::UpdateProxyLOD()
+{
+	const UWorld* World = GetWorld();
+	const float Now = World->GetTimeSeconds();
+	// a dormant proxy already ticks at DormantTickInterval; throttling it again would stack the two intervals
+	if (ProxyLOD != EProxyMovementLOD::Dormant && Now < NextLODUpdateTime)
+		return;
+	NextLODUpdateTime = Now + LODUpdateInterval;
+
+	const APlayerController* LocalController = World->GetFirstPlayerController();
+	if (!CVarProxyMovementLOD.GetValueOnGameThread() || !CharacterOwner || !LocalController)
+	{
+		SetProxyLOD(EProxyMovementLOD::Full);
+		return;
+	}
+
+	if (!CharacterOwner->WasRecentlyRendered(VisibilityTimeout))
+	{
+		SetProxyLOD(EProxyMovementLOD::Dormant);
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	LocalController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	// stay in the current tier until the distance is clearly past the threshold
+	const float Threshold = FullSimulationDistance + (ProxyLOD == EProxyMovementLOD::Full ? LODHysteresis : -LODHysteresis);
+	const bool bNear = FVector::DistSquared(ViewLocation, CharacterOwner->GetActorLocation()) < FMath::Square(Threshold);
+	SetProxyLOD(bNear ? EProxyMovementLOD::Full : EProxyMovementLOD::Interpolated);
+}
+
+void UHelloMultiplayerMovementComponent::SetProxyLOD(EProxyMovementLOD NewLOD)
+{
+	if (NewLOD == ProxyLOD)
+		return;
+
+	if (NewLOD == EProxyMovementLOD::Full)
+	{
+		// the floor wasn't tracked while interpolating
+		bForceNextFloorCheck = true;
+	}
+
+	SetComponentTickInterval(NewLOD == EProxyMovementLOD::Dormant ? DormantTickInterval : 0.f);
+	ProxyLOD = NewLOD;
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HelloMultiplayerMovementComponent.generated.h"
+
+/** How much work a simulated proxy does per frame on this client. */
+UENUM(BlueprintType)
+enum class EProxyMovementLOD : uint8
+{
+	/** Full simulated proxy movement: prediction, collision and floor checks, smoothing. */
+	Full,
+	/** Visible but far: no simulation or collision queries, the mesh is smoothed between replicated snapshots. */
+	Interpolated,
+	/** Not rendered: the mesh is kept on the replicated location, at a reduced tick rate. */
+	Dormant
+};
+
+/**
+ * Character movement with distance and visibility based LOD for simulated proxies (remote characters on clients).
+ * Locally controlled and server-side characters are unaffected.
+ */
+UCLASS()
+class HELLOMULTIPLAYER_API UHelloMultiplayerMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHelloMultiplayerMovementComponent();
+
+	/** Remote characters closer than this to the local view keep full simulation. */
+	UPROPERTY(EditDefaultsOnly, Category="Character Movement: LOD")
+	float FullSimulationDistance = 3000.f;
+
+	/** Distance band around FullSimulationDistance in which the tier is kept, so it doesn't flip back and forth. */
+	UPROPERTY(EditDefaultsOnly, Category="Character Movement: LOD")
+	float LODHysteresis = 300.f;
+
+	/** How recently (in seconds) the character must have been rendered to count as visible. */
+	UPROPERTY(EditDefaultsOnly, Category="Character Movement: LOD")
+	float VisibilityTimeout = 0.25f;
+
+	/** Seconds between tier evaluations. */
+	UPROPERTY(EditDefaultsOnly, Category="Character Movement: LOD")
+	float LODUpdateInterval = 0.2f;
+
+	/** Tick interval while Dormant. Visibility is re-checked on every dormant tick. */
+	UPROPERTY(EditDefaultsOnly, Category="Character Movement: LOD")
+	float DormantTickInterval = 0.2f;
+
+	UFUNCTION(BlueprintPure, Category="Character Movement: LOD")
+	EProxyMovementLOD GetProxyLOD() const { return ProxyLOD; }
+
+	virtual void SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation) override;
+
+protected:
+	virtual void SimulatedTick(float DeltaSeconds) override;
+
+private:
+	void UpdateProxyLOD();
+	void SetProxyLOD(EProxyMovementLOD NewLOD);
+	/** True while a networked root motion montage or root motion source moves the proxy, and for the frame after. */
+	bool IsSimulatingRootMotion() const;
+	void SnapMeshToCapsule();
+
+	EProxyMovementLOD ProxyLOD = EProxyMovementLOD::Full;
+	float NextLODUpdateTime = 0.f;
+};
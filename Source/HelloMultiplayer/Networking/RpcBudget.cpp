@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RpcBudget.h"
+#include "HelloMultiplayer.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server RPCs Accepted"), STAT_RpcAccepted, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server RPCs Dropped"), STAT_RpcDropped, STATGROUP_HelloMultiplayer);
+
+bool FRpcBudget::TryConsume(float Now)
+{
+	if (Tokens < 0.f)
+	{
+		Tokens = BurstSize;
+	}
+	else
+	{
+		Tokens = FMath::Min(BurstSize, Tokens + (Now - LastRefillTime) * RefillRate);
+	}
+	LastRefillTime = Now;
+
+	if (Tokens < 1.f)
+	{
+		++DroppedCount;
+		INC_DWORD_STAT(STAT_RpcDropped);
+		return false;
+	}
+
+	Tokens -= 1.f;
+	++AcceptedCount;
+	INC_DWORD_STAT(STAT_RpcAccepted);
+	return true;
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RpcBudget.generated.h"
+
+/**
+ * Token bucket limiting how often a client may call a server RPC.
+ * Each accepted call takes one token, tokens refill at RefillRate up to BurstSize.
+ */
+USTRUCT(BlueprintType)
+struct HELLOMULTIPLAYER_API FRpcBudget
+{
+	GENERATED_BODY()
+
+	/** Tokens regained per second, i.e. the sustained call rate allowed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Budget")
+	float RefillRate = 10.f;
+
+	/** Maximum number of tokens, i.e. how many calls may arrive back to back. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Budget")
+	float BurstSize = 4.f;
+
+	/** Number of calls accepted since spawn. */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category="Budget")
+	int32 AcceptedCount = 0;
+
+	/** Number of calls dropped for being over budget since spawn. */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category="Budget")
+	int32 DroppedCount = 0;
+
+	FRpcBudget() = default;
+	FRpcBudget(float InRefillRate, float InBurstSize)
+		: RefillRate(InRefillRate)
+		, BurstSize(InBurstSize)
+	{
+	}
+
+	/** Takes a token if one is available. Returns false if the call is over budget and should be dropped. */
+	bool TryConsume(float Now);
+
+private:
+	/** Tokens currently available. Negative until the first call, when the bucket starts full. */
+	float Tokens = -1.f;
+	float LastRefillTime = 0.f;
+};
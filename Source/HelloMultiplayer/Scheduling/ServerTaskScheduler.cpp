@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ServerTaskScheduler.h"
+#include "HelloMultiplayer.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Server Tasks"), STAT_ServerTasks, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server Task Queue Depth"), STAT_ServerTaskQueueDepth, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Tasks Run"), STAT_ServerTasksRun, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server Task Budget Overruns"), STAT_ServerTaskOverruns, STATGROUP_HelloMultiplayer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server Tasks Late"), STAT_ServerTasksLate, STATGROUP_HelloMultiplayer);
+
+static TAutoConsoleVariable<float> CVarServerTaskBudgetMs(
+	TEXT("HelloMultiplayer.ServerTaskBudgetMs"),
+	1.f,
+	TEXT("Milliseconds per frame the server spends on deferred gameplay tasks. Tasks about to miss their deadline run regardless."));
+
+void UServerTaskScheduler::Schedule(const UObject* Owner, TFunction<void()>&& Task, EServerTaskPriority Priority, float MaxDelay)
+{
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		Task();
+		return;
+	}
+
+	FServerTask& Entry = Tasks.AddDefaulted_GetRef();
+	Entry.Owner = Owner;
+	Entry.Task = MoveTemp(Task);
+	Entry.Deadline = GetWorld()->GetTimeSeconds() + FMath::Max(MaxDelay, 0.f);
+	Entry.Sequence = NextSequence++;
+	Entry.Priority = Priority;
+	SET_DWORD_STAT(STAT_ServerTaskQueueDepth, Tasks.Num());
+}
+
+bool UServerTaskScheduler::IsTickable() const
+{
+	return !IsTemplate() && Tasks.Num() > 0;
+}
+
+TStatId UServerTaskScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UServerTaskScheduler, STATGROUP_Tickables);
+}
+
+void UServerTaskScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ServerTasks);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	// anything due before the next frame has to run now
+	const float MustRunBy = Now + DeltaTime;
+
+	Tasks.Sort([MustRunBy](const FServerTask& A, const FServerTask& B)
+	{
+		const bool bADue = A.Deadline <= MustRunBy;
+		const bool bBDue = B.Deadline <= MustRunBy;
+		if (bADue != bBDue)
+			return bADue;
+		if (A.Priority != B.Priority)
+			return A.Priority > B.Priority;
+		if (A.Deadline != B.Deadline)
+			return A.Deadline < B.Deadline;
+		return A.Sequence < B.Sequence;
+	});
+
+	const double BudgetSeconds = FMath::Max(CVarServerTaskBudgetMs.GetValueOnGameThread(), 0.f) / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	// tasks scheduled by a running task are appended past NumQueued and wait for the next frame
+	const int32 NumQueued = Tasks.Num();
+	int32 NumDone = 0;
+	for (; NumDone < NumQueued; ++NumDone)
+	{
+		const bool bOverBudget = FPlatformTime::Seconds() - StartTime >= BudgetSeconds;
+		// always make some progress, even with a zero budget
+		if (bOverBudget && NumDone > 0 && Tasks[NumDone].Deadline > MustRunBy)
+			break;
+
+		if (!Tasks[NumDone].Owner.IsValid())
+			continue;
+
+		if (Tasks[NumDone].Deadline < Now)
+			INC_DWORD_STAT(STAT_ServerTasksLate);
+
+		// the task may schedule more, which can reallocate Tasks
+		TFunction<void()> Task = MoveTemp(Tasks[NumDone].Task);
+		Task();
+		INC_DWORD_STAT(STAT_ServerTasksRun);
+	}
+
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	if (Elapsed > BudgetSeconds)
+	{
+		INC_DWORD_STAT(STAT_ServerTaskOverruns);
+		UE_LOG(LogTemp, Verbose, TEXT("ServerTaskScheduler: %.2f ms spent on a %.2f ms budget, %d tasks left"),
+			Elapsed * 1000.0, BudgetSeconds * 1000.0, Tasks.Num() - NumDone);
+	}
+
+	Tasks.RemoveAt(0, NumDone, false);
+	SET_DWORD_STAT(STAT_ServerTaskQueueDepth, Tasks.Num());
+}
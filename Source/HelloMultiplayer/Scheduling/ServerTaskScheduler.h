@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ServerTaskScheduler.generated.h"
+
+enum class EServerTaskPriority : uint8
+{
+	Low,
+	Normal,
+	High,
+};
+
+/**
+ * Server-side queue for deferred gameplay work (respawns, match setup, stat resets) that doesn't have to run
+ * on the frame it was requested. Each frame runs tasks by priority until HelloMultiplayer.ServerTaskBudgetMs
+ * is spent, so a burst of deaths at round end is spread over several frames. A task that would miss its
+ * deadline by waiting another frame runs even if the budget is already spent; that frame counts as an overrun.
+ */
+UCLASS()
+class HELLOMULTIPLAYER_API UServerTaskScheduler : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Queues Task to run within MaxDelay seconds. The task is dropped if Owner is destroyed before it runs.
+	 * On clients there is nothing to spread, so the task runs immediately.
+	 */
+	void Schedule(const UObject* Owner, TFunction<void()>&& Task, EServerTaskPriority Priority, float MaxDelay);
+
+	int32 GetQueueDepth() const { return Tasks.Num(); }
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject
+
+private:
+	struct FServerTask
+	{
+		TWeakObjectPtr<const UObject> Owner;
+		TFunction<void()> Task;
+		float Deadline = 0.f;
+		/** Keeps tasks of equal priority and deadline in the order they were scheduled. */
+		uint32 Sequence = 0;
+		EServerTaskPriority Priority = EServerTaskPriority::Normal;
+	};
+
+	TArray<FServerTask> Tasks;
+	uint32 NextSequence = 0;
+};
@@ -2,15 +2,59 @@
 
 
 #include "Stat.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Net/UnrealNetwork.h"
+
+void FStatAttributeValue::Aggregate()
+{
+	float Additive = 0.f;
+	float Multiplier = 1.f;
+	const FStatModifier* Override = nullptr;
+	NextExpiryTime = 0.f;
+
+	for (const FStatModifier& Modifier : Modifiers)
+	{
+		switch (Modifier.Op)
+		{
+		case EStatModifierOp::Additive:
+			Additive += Modifier.Magnitude;
+			break;
+		case EStatModifierOp::Multiplicative:
+			Multiplier *= Modifier.Magnitude;
+			break;
+		case EStatModifierOp::Override:
+			// handles grow with every AddModifier, so the largest one is the most recent
+			if (!Override || Modifier.Handle > Override->Handle)
+			{
+				Override = &Modifier;
+			}
+			break;
+		}
+
+		if (Modifier.ExpiryTime > 0.f && (NextExpiryTime <= 0.f || Modifier.ExpiryTime < NextExpiryTime))
+		{
+			NextExpiryTime = Modifier.ExpiryTime;
+		}
+	}
+
+	CachedValue = Override ? Override->Magnitude : (BaseValue + Additive) * Multiplier;
+}
 
 // Sets default values for this component's properties
 UStat::UStat()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
+	// Only ticks while a modifier is waiting to expire, see UpdateNextExpiry.
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	SetIsReplicatedByDefault(true);
 
-	// ...
+	Attributes.SetNum((int32)EStatAttribute::Count);
+	Attributes[(int32)EStatAttribute::DamageTaken].BaseValue = 1.f;
+	Attributes[(int32)EStatAttribute::DamageTaken].CachedValue = 1.f;
 }
 
 
@@ -18,17 +62,200 @@ UStat::UStat()
 void UStat::BeginPlay()
 {
 	Super::BeginPlay();
-
-	// ...
 	
 }
 
+void UStat::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UStat, Attributes);
+}
+
+float UStat::GetNow() const
+{
+	const UWorld* World = GetWorld();
+	if (!World)
+		return 0.f;
+
+	// server time, so expiry times mean the same thing on every machine
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+void UStat::SetBaseValue(EStatAttribute Attribute, float Value)
+{
+	Attributes[(int32)Attribute].BaseValue = Value;
+	Reaggregate((int32)Attribute);
+}
+
+int32 UStat::AddModifier(EStatAttribute Attribute, EStatModifierOp Op, float Magnitude, float Duration)
+{
+	FStatModifier& Modifier = Attributes[(int32)Attribute].Modifiers.AddDefaulted_GetRef();
+	Modifier.Handle = (NextHandleSerial++ << 8) | (int32)Attribute;
+	Modifier.Op = Op;
+	Modifier.Magnitude = Magnitude;
+	Modifier.ExpiryTime = Duration > 0.f ? GetNow() + Duration : 0.f;
+
+	const int32 Handle = Modifier.Handle;
+	Reaggregate((int32)Attribute);
+	UpdateNextExpiry();
+	return Handle;
+}
+
+bool UStat::RemoveModifier(int32 Handle)
+{
+	const int32 Index = Handle & 0xFF;
+	if (Handle == INDEX_NONE || !Attributes.IsValidIndex(Index))
+		return false;
+
+	FStatAttributeValue& Entry = Attributes[Index];
+	const int32 Removed = Entry.Modifiers.RemoveAllSwap([Handle](const FStatModifier& Modifier) { return Modifier.Handle == Handle; });
+	if (Removed == 0)
+		return false;
+
+	Reaggregate(Index);
+	UpdateNextExpiry();
+	return true;
+}
+
+void UStat::ClearModifiers()
+{
+	for (int32 Index = 0; Index < Attributes.Num(); ++Index)
+	{
+		Attributes[Index].Modifiers.Reset();
+		Reaggregate(Index);
+	}
+	UpdateNextExpiry();
+}
+
+void UStat::RemoveExpiredModifiers(float Now)
+{
+	if (NextExpiryTime <= 0.f || Now < NextExpiryTime)
+		return;
+
+	for (int32 Index = 0; Index < Attributes.Num(); ++Index)
+	{
+		FStatAttributeValue& Entry = Attributes[Index];
+		if (Entry.NextExpiryTime <= 0.f || Now < Entry.NextExpiryTime)
+			continue;
+
+		Entry.Modifiers.RemoveAllSwap([Now](const FStatModifier& Modifier) { return Modifier.ExpiryTime > 0.f && Modifier.ExpiryTime <= Now; });
+		Reaggregate(Index);
+	}
+	UpdateNextExpiry();
+}
+
+void UStat::Reaggregate(int32 Index)
+{
+	FStatAttributeValue& Entry = Attributes[Index];
+	const float OldValue = Entry.CachedValue;
+	Entry.Aggregate();
+	if (Entry.CachedValue != OldValue)
+	{
+		OnAttributeChanged.Broadcast((EStatAttribute)Index, Entry.CachedValue);
+	}
+}
+
+void UStat::UpdateNextExpiry()
+{
+	NextExpiryTime = 0.f;
+	for (const FStatAttributeValue& Entry : Attributes)
+	{
+		if (Entry.NextExpiryTime > 0.f && (NextExpiryTime <= 0.f || Entry.NextExpiryTime < NextExpiryTime))
+		{
+			NextExpiryTime = Entry.NextExpiryTime;
+		}
+	}
+
+	// clients get the results through replication, only the server expires modifiers
+	const AActor* Owner = GetOwner();
+	SetComponentTickEnabled(NextExpiryTime > 0.f && Owner && Owner->HasAuthority());
+}
+
 
 // Called every frame
 void UStat::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	// ...
+	RemoveExpiredModifiers(GetNow());
 }
 
+namespace
+{
+	/**
+	 * HelloMultiplayer.StatBench [Modifiers] [Reads]
+	 * Times adding, reading, expiring and removing modifiers on a standalone UStat, and compares cached
+	 * reads with aggregating on every read.
+	 */
+	void StatBench(const TArray<FString>& Args)
+	{
+		const int32 NumModifiers = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 5000;
+		const int32 NumReads = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000000;
+		const int32 NumAttributes = (int32)EStatAttribute::Count;
+
+		UStat* Stat = NewObject<UStat>();
+		FRandomStream Random(1234);
+		TArray<int32> Handles;
+		Handles.Reserve(NumModifiers);
+
+		double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumModifiers; ++i)
+		{
+			const EStatAttribute Attribute = (EStatAttribute)Random.RandRange(0, NumAttributes - 1);
+			const EStatModifierOp Op = Random.FRand() < 0.6f ? EStatModifierOp::Additive : EStatModifierOp::Multiplicative;
+			// without a world the clock stands at zero, so these expire at 1..10
+			Handles.Add(Stat->AddModifier(Attribute, Op, Random.FRandRange(0.99f, 1.01f), Random.FRandRange(1.f, 10.f)));
+		}
+		const double AddSeconds = FPlatformTime::Seconds() - Start;
+
+		float Sink = 0.f;
+		Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumReads; ++i)
+		{
+			Sink += Stat->GetValue((EStatAttribute)(i % NumAttributes));
+		}
+		const double CachedReadSeconds = FPlatformTime::Seconds() - Start;
+
+		// what every TakeDamage / StartFire / CanRoll would cost if stacks were aggregated on read
+		const int32 NumUncachedReads = FMath::Max(1, NumReads / 100);
+		FStatAttributeValue Probe;
+		Probe.Modifiers.SetNum(NumModifiers / NumAttributes);
+		for (FStatModifier& Modifier : Probe.Modifiers)
+		{
+			Modifier.Magnitude = 1.f;
+		}
+		Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumUncachedReads; ++i)
+		{
+			Probe.Aggregate();
+			Sink += Probe.CachedValue;
+		}
+		const double UncachedReadSeconds = FPlatformTime::Seconds() - Start;
+
+		Start = FPlatformTime::Seconds();
+		Stat->RemoveExpiredModifiers(5.f);
+		const double ExpireSeconds = FPlatformTime::Seconds() - Start;
+
+		Start = FPlatformTime::Seconds();
+		int32 Removed = 0;
+		for (const int32 Handle : Handles)
+		{
+			Removed += Stat->RemoveModifier(Handle) ? 1 : 0;
+		}
+		const double RemoveSeconds = FPlatformTime::Seconds() - Start;
+
+		UE_LOG(LogTemp, Display, TEXT("StatBench: %d modifiers over %d attributes (sink %f)"), NumModifiers, NumAttributes, Sink);
+		UE_LOG(LogTemp, Display, TEXT("  add:            %8.3f us/modifier"), AddSeconds * 1e6 / NumModifiers);
+		UE_LOG(LogTemp, Display, TEXT("  cached read:    %8.4f ns/read"), CachedReadSeconds * 1e9 / NumReads);
+		UE_LOG(LogTemp, Display, TEXT("  aggregate read: %8.4f ns/read (%d modifiers per attribute)"), UncachedReadSeconds * 1e9 / NumUncachedReads, Probe.Modifiers.Num());
+		UE_LOG(LogTemp, Display, TEXT("  expire half:    %8.3f us"), ExpireSeconds * 1e6);
+		UE_LOG(LogTemp, Display, TEXT("  remove rest:    %8.3f us/modifier (%d removed)"), RemoveSeconds * 1e6 / FMath::Max(1, Removed), Removed);
+	}
+
+	FAutoConsoleCommand StatBenchCommand(
+		TEXT("HelloMultiplayer.StatBench"),
+		TEXT("Benchmarks UStat modifier aggregation. Args: [Modifiers=5000] [Reads=1000000]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&StatBench));
+}
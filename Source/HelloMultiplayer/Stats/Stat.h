@@ -6,7 +6,81 @@
 #include "Components/ActorComponent.h"
 #include "Stat.generated.h"
 
+/** Attributes that buffs and debuffs can modify. */
+UENUM(BlueprintType)
+enum class EStatAttribute : uint8
+{
+	MaxHealth,
+	MaxMana,
+	/** Delay between shots in seconds, lower is faster. */
+	FireRate,
+	/** Multiplier applied to incoming damage. Base value is 1. */
+	DamageTaken,
+	RollCooldown,
+
+	Count UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EStatModifierOp : uint8
+{
+	/** Added to the base value. */
+	Additive,
+	/** Multiplies base + additives. */
+	Multiplicative,
+	/** Replaces the result. The most recently added override wins. */
+	Override
+};
+
+USTRUCT(BlueprintType)
+struct FStatModifier
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Handle = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="Stats")
+	EStatModifierOp Op = EStatModifierOp::Additive;
+
+	UPROPERTY(BlueprintReadOnly, Category="Stats")
+	float Magnitude = 0.f;
+
+	/** Server world time at which the modifier is removed, zero or less for never. */
+	UPROPERTY(BlueprintReadOnly, Category="Stats")
+	float ExpiryTime = 0.f;
+};
+
+/** One attribute: its base value, its modifiers stored contiguously, and the aggregated result. */
+USTRUCT(BlueprintType)
+struct FStatAttributeValue
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="Stats")
+	float BaseValue = 0.f;
 
+	/** Aggregated value, recomputed only when a modifier is added, removed or expires. */
+	UPROPERTY(BlueprintReadOnly, Category="Stats")
+	float CachedValue = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category="Stats")
+	TArray<FStatModifier> Modifiers;
+
+	/** Earliest ExpiryTime among Modifiers, zero or less if none expire. */
+	float NextExpiryTime = 0.f;
+
+	/** Recomputes CachedValue and NextExpiryTime from BaseValue and Modifiers. */
+	void Aggregate();
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnStatAttributeChanged, EStatAttribute /*Attribute*/, float /*NewValue*/);
+
+/**
+ * Holds the modifiable attributes of an actor. Modifiers are added and removed on the server and the
+ * aggregated values replicate, so reading an attribute anywhere is a single cached read.
+ * Only ticks while a modifier with an expiry time is active.
+ */
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class HELLOMULTIPLAYER_API UStat : public UActorComponent
 {
@@ -16,6 +90,37 @@ public:
 	// Sets default values for this component's properties
 	UStat();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Aggregated value of an attribute. */
+	UFUNCTION(BlueprintPure, Category="Stats")
+	float GetValue(EStatAttribute Attribute) const { return Attributes[(int32)Attribute].CachedValue; }
+
+	UFUNCTION(BlueprintCallable, Category="Stats")
+	void SetBaseValue(EStatAttribute Attribute, float Value);
+
+	/**
+	 * Adds a modifier to an attribute.
+	 * @param Duration	Seconds until the modifier is removed, zero or less for never
+	 * @return handle for RemoveModifier
+	 */
+	UFUNCTION(BlueprintCallable, Category="Stats")
+	int32 AddModifier(EStatAttribute Attribute, EStatModifierOp Op, float Magnitude, float Duration = 0.f);
+
+	/** Removes a modifier added by AddModifier. Returns false if it was already removed or expired. */
+	UFUNCTION(BlueprintCallable, Category="Stats")
+	bool RemoveModifier(int32 Handle);
+
+	/** Removes every modifier, leaving the base values. */
+	UFUNCTION(BlueprintCallable, Category="Stats")
+	void ClearModifiers();
+
+	/** Removes expired modifiers. Called from TickComponent, exposed for callers that drive time themselves. */
+	void RemoveExpiredModifiers(float Now);
+
+	/** Broadcast on the machine that changed it whenever an attribute's aggregated value changes. Not called for replicated updates. */
+	FOnStatAttributeChanged OnAttributeChanged;
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
@@ -24,5 +129,19 @@ public:
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
-		
+private:
+	/** One entry per EStatAttribute, indexed by the enum value. */
+	UPROPERTY(Replicated)
+	TArray<FStatAttributeValue> Attributes;
+
+	/** Low byte of a handle is the attribute index, the rest is a serial number. */
+	int32 NextHandleSerial = 1;
+
+	/** Earliest expiry over all attributes, zero or less if nothing expires. */
+	float NextExpiryTime = 0.f;
+
+	float GetNow() const;
+	void UpdateNextExpiry();
+	/** Aggregates one attribute and broadcasts OnAttributeChanged if its value changed. */
+	void Reaggregate(int32 Index);
 };
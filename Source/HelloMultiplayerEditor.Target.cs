@@ -10,5 +10,6 @@ public class HelloMultiplayerEditorTarget : TargetRules
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		ExtraModuleNames.Add("HelloMultiplayer");
+		ExtraModuleNames.Add("HelloMultiplayerUI");
 	}
 }
@@ -11,7 +11,7 @@
  * 
  */
 UCLASS()
-class HELLOMULTIPLAYER_API UHealthBar : public UWidgetComponent
+class HELLOMULTIPLAYERUI_API UHealthBar : public UWidgetComponent
 {
 	GENERATED_BODY()
 
@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class HelloMultiplayerUI : ModuleRules
+{
+	public HelloMultiplayerUI(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Widgets only. Listed as ClientOnly in the .uproject and left out of the server target, so dedicated
+		// servers don't compile or link UMG and Slate.
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "UMG" });
+	}
+}